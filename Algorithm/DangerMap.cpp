@@ -0,0 +1,56 @@
+#include "DangerMap.h"
+#include <algorithm>
+
+namespace Algorithm
+{
+    using namespace UserCommon;
+    using namespace std;
+
+    // Deltas in Directions::directionOrder() order: U, UR, R, DR, D, DL, L, UL
+    static constexpr int DX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static constexpr int DY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+    void DangerMap::build(const WorldModel &world)
+    {
+        width = world.getWidth();
+        height = world.getHeight();
+        size_t words = (width * height + 63) / 64;
+
+        mines.assign(words, 0);
+        for (auto &bits : steps)
+            bits.assign(words, 0);
+        if (words == 0)
+            return;
+
+        for (const auto &mine : world.getMines())
+            set(mines, indexOf(mine));
+
+        int w = static_cast<int>(width), h = static_cast<int>(height);
+        for (const auto &shell : world.getShells())
+        {
+            set(steps[0], indexOf(shell));
+            for (int dir = 0; dir < 8; ++dir)
+            {
+                int x = shell.x, y = shell.y;
+                // a shell covers cells 2t-1 and 2t of its ray during tank step t
+                for (int dist = 1; dist <= 2 * HORIZON; ++dist)
+                {
+                    x = (x + DX[dir] + w) % w;
+                    y = (y + DY[dir] + h) % h;
+                    Position p(x, y);
+                    if (world.at(p) == '#')
+                        break;
+                    set(steps[(dist + 1) / 2], indexOf(p));
+                }
+            }
+        }
+    }
+
+    bool DangerMap::isDangerous(const Position &cell, int step) const
+    {
+        if (cell.x < 0 || cell.y < 0 || size_t(cell.x) >= width || size_t(cell.y) >= height)
+            return false;
+        size_t i = indexOf(cell);
+        return test(mines, i) || test(steps[clamp(step, 0, HORIZON)], i);
+    }
+}
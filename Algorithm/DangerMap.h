@@ -0,0 +1,36 @@
+#pragma once
+#include "WorldModel.h"
+#include "UserCommon/Position.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Algorithm
+{
+
+    // Where shells can be over the next few tank steps, as one bitset per step.
+    // Shell directions are not visible on the satellite view, so each shell is projected along all
+    // 8 directions (two cells per tank step) until a wall stops it. Mines are dangerous at every step.
+    class DangerMap
+    {
+    public:
+        static constexpr int HORIZON = 3; // tank steps projected ahead of the snapshot
+
+    private:
+        size_t width = 0, height = 0;
+        std::vector<uint64_t> mines;
+        std::vector<uint64_t> steps[HORIZON + 1]; // steps[t]: a shell may be in or pass through the cell during step t
+
+        size_t indexOf(const UserCommon::Position &pos) const { return size_t(pos.y) * width + pos.x; }
+        static void set(std::vector<uint64_t> &bits, size_t i) { bits[i >> 6] |= uint64_t(1) << (i & 63); }
+        static bool test(const std::vector<uint64_t> &bits, size_t i) { return (bits[i >> 6] >> (i & 63)) & 1; }
+
+    public:
+        DangerMap() = default;
+
+        void build(const WorldModel &world);
+
+        // Is the cell dangerous at tank step t after the snapshot (clamped to the horizon)
+        bool isDangerous(const UserCommon::Position &cell, int step) const;
+    };
+}
@@ -0,0 +1,125 @@
+#include "LineOfFireIndex.h"
+
+namespace Algorithm
+{
+    using namespace UserCommon;
+    using namespace std;
+
+    // Deltas in Directions::directionOrder() order: U, UR, R, DR, D, DL, L, UL
+    static constexpr int DX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static constexpr int DY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+    // Capture the occupancy of the snapshot; direction tables are filled on demand
+    void LineOfFireIndex::build(const WorldModel &world)
+    {
+        width = static_cast<int>(world.getWidth());
+        height = static_cast<int>(world.getHeight());
+        size_t n = size_t(width) * height;
+
+        cells.assign(n, EMPTY);
+        owners.assign(n, 0);
+        for (auto &steps : tankSteps)
+            steps.clear();
+        for (auto &steps : wallSteps)
+            steps.clear();
+
+        for (const auto &[player_idx, tank_idx, tank_pos] : world.getTanks())
+        {
+            cells[indexOf(tank_pos)] = TANK;
+            owners[indexOf(tank_pos)] = static_cast<int8_t>(player_idx);
+        }
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if (world.at(Position(x, y)) == '#')
+                    cells[size_t(y) * width + x] = WALL;
+            }
+        }
+    }
+
+    bool LineOfFireIndex::contains(const Position &pos) const
+    {
+        return pos.x >= 0 && pos.y >= 0 && pos.x < width && pos.y < height;
+    }
+
+    // Walk every wrapping line of the direction once. Going twice around each cycle backwards
+    // gives every cell the distance to the next tank / wall ahead of it, including wrap-around.
+    void LineOfFireIndex::buildDirection(int dir) const
+    {
+        size_t n = cells.size();
+        auto &tanks = tankSteps[dir];
+        auto &walls = wallSteps[dir];
+        tanks.assign(n, 0);
+        walls.assign(n, 0);
+
+        vector<char> visited(n, 0);
+        vector<size_t> cycle;
+        for (size_t start = 0; start < n; ++start)
+        {
+            if (visited[start])
+                continue;
+
+            cycle.clear();
+            size_t cell = start;
+            do
+            {
+                visited[cell] = 1;
+                cycle.push_back(cell);
+                int x = static_cast<int>(cell % width);
+                int y = static_cast<int>(cell / width);
+                x = (x + DX[dir] + width) % width;
+                y = (y + DY[dir] + height) % height;
+                cell = size_t(y) * width + x;
+            } while (cell != start);
+
+            long len = static_cast<long>(cycle.size());
+            long nextTank = -1, nextWall = -1;
+            for (long i = 2 * len - 1; i >= 0; --i)
+            {
+                size_t c = cycle[i % len];
+                if (i < len)
+                {
+                    if (nextTank >= 0 && nextTank - i < len)
+                        tanks[c] = static_cast<int32_t>(nextTank - i);
+                    if (nextWall >= 0 && nextWall - i < len)
+                        walls[c] = static_cast<int32_t>(nextWall - i);
+                }
+                if (cells[c] == TANK)
+                    nextTank = i;
+                else if (cells[c] == WALL)
+                    nextWall = i;
+            }
+        }
+    }
+
+    int LineOfFireIndex::nearestTank(const Position &pos, int dir) const
+    {
+        if (!contains(pos))
+            return 0;
+        if (tankSteps[dir].empty())
+            buildDirection(dir);
+        return tankSteps[dir][indexOf(pos)];
+    }
+
+    int LineOfFireIndex::nearestWall(const Position &pos, int dir) const
+    {
+        if (!contains(pos))
+            return 0;
+        if (wallSteps[dir].empty())
+            buildDirection(dir);
+        return wallSteps[dir][indexOf(pos)];
+    }
+
+    int LineOfFireIndex::ownerAt(const Position &pos) const
+    {
+        return contains(pos) ? owners[indexOf(pos)] : 0;
+    }
+
+    Position LineOfFireIndex::advance(const Position &pos, int dir, int steps) const
+    {
+        long x = (pos.x + static_cast<long>(DX[dir]) * steps) % width;
+        long y = (pos.y + static_cast<long>(DY[dir]) * steps) % height;
+        return Position(static_cast<int>((x + width) % width), static_cast<int>((y + height) % height));
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "UserCommon/Position.h"
+#include "WorldModel.h"
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Algorithm
+{
+
+    // Line-of-sight index over one battle info snapshot.
+    // For every cell and each of the 8 directions it knows how many steps along the wrapping
+    // ray the nearest tank and the nearest wall are, so a line-of-fire query is O(1).
+    // Each direction is filled by one linear pass over the grid the first time it is queried.
+    class LineOfFireIndex
+    {
+    private:
+        enum CellKind : uint8_t
+        {
+            EMPTY,
+            WALL,
+            TANK
+        };
+
+        int width = 0, height = 0;
+        std::vector<uint8_t> cells; // row-major, y * width + x
+        std::vector<int8_t> owners; // player index of the tank in a cell, 0 if none
+
+        // steps to the nearest tank / wall per direction, 0 when the ray only comes back to its origin
+        mutable std::array<std::vector<int32_t>, 8> tankSteps;
+        mutable std::array<std::vector<int32_t>, 8> wallSteps;
+
+        size_t indexOf(const UserCommon::Position &pos) const { return size_t(pos.y) * width + pos.x; }
+        bool contains(const UserCommon::Position &pos) const;
+        void buildDirection(int dir) const;
+
+    public:
+        LineOfFireIndex() = default;
+
+        void build(const WorldModel &world);
+
+        int nearestTank(const UserCommon::Position &pos, int dir) const;
+        int nearestWall(const UserCommon::Position &pos, int dir) const;
+        int ownerAt(const UserCommon::Position &pos) const;
+        UserCommon::Position advance(const UserCommon::Position &pos, int dir, int steps) const;
+    };
+}
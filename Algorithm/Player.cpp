@@ -1,11 +1,8 @@
 #include "Player.h"
-#include "TankAlgorithm.h"
-#include "UserCommon/GameBoard.h"
+#include "TankAlgorithm_A.h"
+#include "WorldModel.h"
 #include "common/TankAlgorithm.h"
-#include "UserCommon/Position.h"
 #include "common/PlayerRegistration.h"
-#include <set>
-#include <vector>
 
 namespace Algorithm
 {
@@ -17,42 +14,24 @@ namespace Algorithm
     {
     }
 
+    // A tank whose view shows the same board as the last one decoded (as the tanks of one round usually
+    // see it, unless a shell was fired in between) shares that snapshot; any other view is decoded afresh
     void MyPlayer::updateTankWithBattleInfo(TankAlgorithm &tank, SatelliteView &satellite_view)
     {
-        set<Position> walls;
-        set<Position> mines;
-        vector<tuple<int, int, Position>> tanks;
-        vector<Position> shells;
-        for (size_t i = 0; i < this->x; i++)
+        Position self;
+        if (snapshot && snapshot->getWorld().sameView(satellite_view, this->x, this->y, index, self))
         {
-            for (size_t j = 0; j < this->y; j++)
-            {
-                char obj = satellite_view.getObjectAt(i, j);
-
-                if (obj == '#')
-                {
-                    walls.insert(Position(i, j));
-                }
-                else if (obj == '*')
-                {
-                    shells.emplace_back(Position(i, j));
-                }
-                else if (obj == '@')
-                {
-                    mines.insert(Position(i, j));
-                }
-                else if (obj == '1' || obj == '2')
-                {
-                    tanks.emplace_back(obj - '0', -1, Position(i, j));
-                }
-                else if (obj == '%')
-                {
-                    tanks.emplace_back(index, -2, Position(i, j));
-                }
-            }
+            SnapshotInfo info(snapshot, self);
+            tank.updateBattleInfo(info);
+            return;
         }
-        GameBoard board(this->x, this->y, size_t(0), walls, mines, move(tanks));
-        tank.updateBattleInfo(board);
+
+        WorldModel world;
+        self = world.decode(satellite_view, this->x, this->y, index);
+        snapshot = make_shared<const WorldSnapshot>(std::move(world));
+
+        SnapshotInfo info(snapshot, self);
+        tank.updateBattleInfo(info);
     }
 }
 using Algorithm::MyPlayer;
@@ -1,7 +1,9 @@
 #pragma once
 #include "common/Player.h"
 #include "common/PlayerRegistration.h"
-#include "UserCommon/GameBoard.h"
+#include "UserCommon/Position.h"
+#include "WorldSnapshot.h"
+#include <memory>
 
 namespace Algorithm
 {
@@ -12,6 +14,9 @@ namespace Algorithm
         int index;
         size_t x, y, max_steps, num_shells;
 
+        // Snapshot of the last view decoded, shared by every tank whose view shows the same board
+        std::shared_ptr<const WorldSnapshot> snapshot;
+
     public:
         MyPlayer(int Myplayer_index, size_t x, size_t y, size_t max_steps, size_t num_shells);
         ~MyPlayer() = default;
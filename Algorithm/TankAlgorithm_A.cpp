@@ -34,14 +34,13 @@ namespace Algorithm
     }
   }
 
-  map<ActionRequest, int> actionToIndex = {
+  // Internal linkage: several copies of this plugin may be loaded into one simulator
+  static const map<ActionRequest, int> actionToIndex = {
       {ActionRequest::RotateLeft45, 7}, {ActionRequest::RotateRight45, 1}, {ActionRequest::RotateLeft90, 6}, {ActionRequest::RotateRight90, 2}};
 
-  vector<tuple<int, int, Position>> emptyTanks = {};
-
   // Constructor
   TankAlgorithm_A::TankAlgorithm_A(int player_index, int tank_index)
-      : tanks(emptyTanks), playerIndex(player_index), tankIndex(tank_index), turn_num(-1)
+      : playerIndex(player_index), tankIndex(tank_index), turn_num(-1), infoTurn(-1), snapshot(WorldSnapshot::empty())
   {
     direction = (player_index == 1) ? "L" : "R";
   }
@@ -52,22 +51,17 @@ namespace Algorithm
   // Updates game state
   void TankAlgorithm_A::updateBattleInfo(BattleInfo &info)
   {
-    GameBoard *gb_ptr = dynamic_cast<GameBoard *>(&info);
-    if (gb_ptr)
-    {
-      board = *gb_ptr;
-    }
-    else
+    SnapshotInfo *info_ptr = dynamic_cast<SnapshotInfo *>(&info);
+    if (!info_ptr)
     {
-      std::cerr << "Error: BattleInfo is not a GameBoard\n";
+      std::cerr << "Error: BattleInfo is not a SnapshotInfo\n";
+      return;
     }
-    tanks = board.getTanks();
-    for (const auto &[player_idx, tank_idx, tank_pos] : tanks)
+    snapshot = info_ptr->getSnapshot();
+    infoTurn = turn_num;
+    if (info_ptr->getSelf() != Position())
     {
-      if (tank_idx == -2)
-      {
-        pos = tank_pos;
-      }
+      pos = info_ptr->getSelf();
     }
   }
 
@@ -194,12 +188,11 @@ namespace Algorithm
     // Try to escape danger if currently in a danger zone
     Position currentPos = this->pos;
     string currentDir = this->direction;
-    set<Position> dangerZones = computeDangerZones();
 
-    if (dangerZones.count(currentPos))
+    if (isInDanger(currentPos))
     {
       Position forwardPos = currentPos + Directions::directions().at(currentDir);
-      if (isFree(forwardPos) && dangerZones.count(forwardPos) == 0)
+      if (isFree(forwardPos) && !isInDanger(forwardPos))
       {
         return ActionRequest::MoveForward;
       }
@@ -211,7 +204,7 @@ namespace Algorithm
         string newDir = Directions::directionOrder()[(dirIndex + indexOffset) % 8];
         Position newPos = currentPos + Directions::directions().at(newDir);
 
-        if (isFree(newPos) && dangerZones.count(newPos) == 0)
+        if (isFree(newPos) && !isInDanger(newPos))
         {
           path.push(rotation);
           path.push(ActionRequest::MoveForward);
@@ -223,7 +216,7 @@ namespace Algorithm
       if (path.empty())
       {
         Position backPos = currentPos + Directions::oppDirections().at(currentDir);
-        if (isFree(backPos) && dangerZones.count(backPos) == 0)
+        if (isFree(backPos) && !isInDanger(backPos))
         {
           path.push(ActionRequest::MoveBackward);
         }
@@ -279,41 +272,27 @@ namespace Algorithm
     return ActionRequest::GetBattleInfo;
   }
 
-  // Check if a cell is free of wall or mine
+  // Check if a cell is free of wall, mine or tank
   bool TankAlgorithm_A::isFree(const Position &pos_other)
   {
-    for (const auto &[player_idx, tank_idx, pos] : tanks)
-    {
-      if (pos == pos_other)
-      {
-        return false;
-      }
-    }
-    return board.getWalls().find(pos_other) == board.getWalls().end() &&
-           board.getMines().find(pos_other) == board.getMines().end();
+    return world().isFree(pos_other);
   }
 
-  // Check if tank can shoot an opponent
+  // Check if tank can shoot an opponent: the nearest tank along the line of fire is an enemy and no wall is in between
   bool TankAlgorithm_A::isShootPossible()
   {
-    Position delta = Directions::directions().at(direction);
-    Position current = pos + delta;
-    while (current != this->pos)
+    int dir = Directions::dirToIndex().at(direction);
+    int tankSteps = lineOfFire().nearestTank(pos, dir);
+    if (tankSteps == 0)
     {
-      for (const auto &[player_idx, tank_idx, tank_pos] : tanks)
-      {
-        if (current == tank_pos && player_idx == playerIndex)
-        {
-          return false; // Friendly in line of fire
-        }
-        else if (current == tank_pos && player_idx != playerIndex)
-        {
-          return true;
-        }
-      }
-      current = current + delta;
+      return false;
     }
-    return false;
+    int wallSteps = lineOfFire().nearestWall(pos, dir);
+    if (wallSteps != 0 && wallSteps < tankSteps)
+    {
+      return false; // Wall in line of fire
+    }
+    return lineOfFire().ownerAt(lineOfFire().advance(pos, dir, tankSteps)) != playerIndex;
   }
 
   int TankAlgorithm_A::manhattan(const Position &a, const Position &b)
@@ -326,7 +305,7 @@ namespace Algorithm
     int dist = INT_MAX;
     int curr_dist = INT_MAX;
     Position closest_pos = Position(-1, -1);
-    for (const auto &[player_idx, tank_idx, tank_pos] : tanks)
+    for (const auto &[player_idx, tank_idx, tank_pos] : world().getTanks())
     {
       if (this->playerIndex != player_idx)
       {
@@ -341,23 +320,10 @@ namespace Algorithm
     return closest_pos;
   }
 
-  // compute paths of shells on the board
-  set<Position> TankAlgorithm_A::computeDangerZones()
+  // Danger where the tank will be once this turn resolves, looked up in the snapshot's projected shell paths
+  bool TankAlgorithm_A::isInDanger(const Position &cell) const
   {
-    set<Position> dangerZones;
-    for (const auto &[shellPos, shellDir] : board.getShells())
-    {
-      if (manhattan(shellPos, pos) <= 2)
-      {
-        dangerZones.insert(shellPos);
-      }
-    }
-    // Add mines to danger zones
-    for (const auto &mine : board.getMines())
-    {
-      dangerZones.insert(mine);
-    }
-    return dangerZones;
+    return snapshot->getDanger().isDangerous(cell, turn_num - infoTurn + 1);
   }
 }
 using Algorithm::TankAlgorithm_A;
@@ -2,7 +2,8 @@
 #include "common/TankAlgorithm.h"
 #include "common/TankAlgorithmRegistration.h"
 #include "UserCommon/Position.h"
-#include "UserCommon/GameBoard.h"
+#include "WorldSnapshot.h"
+#include <memory>
 #include <vector>
 #include <set>
 #include <map>
@@ -18,14 +19,17 @@ namespace Algorithm
     {
     private:
         std::queue<ActionRequest> path;
-        std::vector<std::tuple<int, int, UserCommon::Position>> tanks;
         std::string direction;
         int playerIndex, tankIndex;
         UserCommon::Position pos;
         int turn_num;
-        UserCommon::GameBoard board;
+        int infoTurn; // turn the current snapshot arrived on
+        std::shared_ptr<const WorldSnapshot> snapshot;
 
-        std::set<UserCommon::Position> computeDangerZones();
+        const WorldModel &world() const { return snapshot->getWorld(); }
+        const LineOfFireIndex &lineOfFire() const { return snapshot->getLineOfFire(); }
+
+        bool isInDanger(const UserCommon::Position &cell) const;
         bool isShootPossible();
         bool isFree(const UserCommon::Position &pos);
         int manhattan(const UserCommon::Position &a, const UserCommon::Position &b);
@@ -0,0 +1,126 @@
+#include "WorldModel.h"
+#include <algorithm>
+
+namespace Algorithm
+{
+    using namespace UserCommon;
+    using namespace std;
+
+    // Fill the grid row by row straight from the view; object lists are collected on the way
+    Position WorldModel::decode(const SatelliteView &view, size_t width, size_t height, int playerIndex)
+    {
+        this->width = width;
+        this->height = height;
+        Position::width = static_cast<int>(width);
+        Position::height = static_cast<int>(height);
+
+        cells.assign(width * height, ' ');
+        tanks.clear();
+        mines.clear();
+        shells.clear();
+        Position self;
+
+        char ownDigit = static_cast<char>('0' + playerIndex);
+        for (size_t y = 0; y < height; y++)
+        {
+            char *row = cells.data() + y * width;
+            for (size_t x = 0; x < width; x++)
+            {
+                char obj = view.getObjectAt(x, y);
+                Position p(static_cast<int>(x), static_cast<int>(y));
+
+                if (obj == '*')
+                {
+                    shells.push_back(p);
+                }
+                else if (obj == '@')
+                {
+                    mines.push_back(p);
+                }
+                else if (obj == '1' || obj == '2')
+                {
+                    tanks.emplace_back(obj - '0', -1, p);
+                }
+                else if (obj == '%')
+                {
+                    tanks.emplace_back(playerIndex, -1, p);
+                    self = p;
+                    obj = ownDigit;
+                }
+                row[x] = obj;
+            }
+        }
+
+        // Keep the column-major tank order the algorithm has always seen
+        sort(tanks.begin(), tanks.end(), [](const auto &a, const auto &b)
+             { return get<2>(a) < get<2>(b); });
+        return self;
+    }
+
+    bool WorldModel::sameView(const SatelliteView &view, size_t width, size_t height, int playerIndex, Position &self) const
+    {
+        if (width != this->width || height != this->height)
+        {
+            return false;
+        }
+        self = Position();
+        char ownDigit = static_cast<char>('0' + playerIndex);
+
+        // Shells and tanks are what moves between views, so probe their cells before scanning the grid:
+        // a view of another step is usually turned away after a few reads instead of up to width * height
+        for (const Position &shell : shells)
+        {
+            if (view.getObjectAt(shell.x, shell.y) != '*')
+            {
+                return false;
+            }
+        }
+        for (const auto &[player, id, pos] : tanks)
+        {
+            char obj = view.getObjectAt(pos.x, pos.y);
+            if (obj != static_cast<char>('0' + player) && !(obj == '%' && player == playerIndex))
+            {
+                return false;
+            }
+        }
+
+        // A match still needs every cell, since the view can show a new object anywhere
+        for (size_t y = 0; y < height; y++)
+        {
+            const char *row = cells.data() + y * width;
+            for (size_t x = 0; x < width; x++)
+            {
+                char obj = view.getObjectAt(x, y);
+                if (obj == '%')
+                {
+                    if (row[x] != ownDigit)
+                    {
+                        return false;
+                    }
+                    self = Position(static_cast<int>(x), static_cast<int>(y));
+                }
+                else if (obj != row[x])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    char WorldModel::at(const Position &pos) const
+    {
+        if (pos.x < 0 || pos.y < 0 || size_t(pos.x) >= width || size_t(pos.y) >= height)
+        {
+            return '&';
+        }
+        return cells[size_t(pos.y) * width + pos.x];
+    }
+
+    // A cell is free when it holds no wall, mine or tank
+    bool WorldModel::isFree(const Position &pos) const
+    {
+        char obj = at(pos);
+        return obj != '#' && obj != '@' && obj != '1' && obj != '2' && obj != '&';
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "common/SatelliteView.h"
+#include "UserCommon/Position.h"
+#include <vector>
+#include <tuple>
+#include <cstddef>
+
+namespace Algorithm
+{
+
+    // Dense picture of the battlefield as the player last saw it, decoded from a SatelliteView in a single pass.
+    // Own tanks, including the one that asked, are stored as the player's digit.
+    class WorldModel
+    {
+    private:
+        size_t width = 0, height = 0;
+        std::vector<char> cells; // row-major satellite chars, the own tank stored as its player digit
+        std::vector<std::tuple<int, int, UserCommon::Position>> tanks;
+        std::vector<UserCommon::Position> mines;
+        std::vector<UserCommon::Position> shells;
+
+    public:
+        WorldModel() = default;
+
+        // Returns the position of the asking tank ('%'), (-1,-1) if the view has none
+        UserCommon::Position decode(const SatelliteView &view, size_t width, size_t height, int playerIndex);
+
+        // True if decoding view would give this model again, i.e. it differs from the view this model was
+        // decoded from at most in which own tank is the asking one; self is then set like decode() does
+        bool sameView(const SatelliteView &view, size_t width, size_t height, int playerIndex, UserCommon::Position &self) const;
+
+        size_t getWidth() const { return width; }
+        size_t getHeight() const { return height; }
+        char at(const UserCommon::Position &pos) const;
+        bool isFree(const UserCommon::Position &pos) const;
+
+        const std::vector<std::tuple<int, int, UserCommon::Position>> &getTanks() const { return tanks; }
+        const std::vector<UserCommon::Position> &getMines() const { return mines; }
+        const std::vector<UserCommon::Position> &getShells() const { return shells; }
+    };
+}
@@ -0,0 +1,19 @@
+#include "WorldSnapshot.h"
+
+namespace Algorithm
+{
+    using namespace std;
+
+    WorldSnapshot::WorldSnapshot(WorldModel &&world)
+        : world(std::move(world))
+    {
+        lineOfFire.build(this->world);
+        danger.build(this->world);
+    }
+
+    const shared_ptr<const WorldSnapshot> &WorldSnapshot::empty()
+    {
+        static const shared_ptr<const WorldSnapshot> snapshot = make_shared<const WorldSnapshot>(WorldModel());
+        return snapshot;
+    }
+}
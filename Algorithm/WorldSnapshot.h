@@ -0,0 +1,46 @@
+#pragma once
+#include "common/BattleInfo.h"
+#include "WorldModel.h"
+#include "LineOfFireIndex.h"
+#include "DangerMap.h"
+#include <memory>
+
+namespace Algorithm
+{
+
+    // Immutable battlefield state of one battle info epoch.
+    // All tanks of a player whose views show the same board hold the same instance.
+    class WorldSnapshot
+    {
+    private:
+        WorldModel world;
+        LineOfFireIndex lineOfFire;
+        DangerMap danger;
+
+    public:
+        explicit WorldSnapshot(WorldModel &&world);
+
+        const WorldModel &getWorld() const { return world; }
+        const LineOfFireIndex &getLineOfFire() const { return lineOfFire; }
+        const DangerMap &getDanger() const { return danger; }
+
+        // Shared placeholder for tanks that have not received battle info yet
+        static const std::shared_ptr<const WorldSnapshot> &empty();
+    };
+
+    // BattleInfo handed from MyPlayer to a tank: the shared snapshot plus the tank's own position in it
+    class SnapshotInfo : public BattleInfo
+    {
+    private:
+        std::shared_ptr<const WorldSnapshot> snapshot;
+        UserCommon::Position self;
+
+    public:
+        SnapshotInfo(std::shared_ptr<const WorldSnapshot> snapshot, UserCommon::Position self)
+            : snapshot(std::move(snapshot)), self(self) {}
+        ~SnapshotInfo() override = default;
+
+        const std::shared_ptr<const WorldSnapshot> &getSnapshot() const { return snapshot; }
+        const UserCommon::Position &getSelf() const { return self; }
+    };
+}
@@ -0,0 +1,198 @@
+#include "BenchSupport.h"
+#include "AllocCounter.h"
+#include "Algorithm/Player.h"
+#include "Algorithm/TankAlgorithm_A.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace UserCommon;
+using Benchmark::SyntheticBoardSpec;
+
+struct BenchResult
+{
+    SyntheticBoardSpec spec;
+    size_t actions = 0, battleInfos = 0;
+    double nsPerAction = 0, allocsPerAction = 0, bytesPerAction = 0;
+    long peakRssKb = 0;
+};
+
+// Play player 1's tanks against a static synthetic board: every tank asks for its action each
+// round and battle info requests go through MyPlayer, the same way the game manager drives them.
+BenchResult runCase(const SyntheticBoardSpec &spec, size_t minActions, double minNs)
+{
+    Benchmark::resetPeakRss();
+    auto board = Benchmark::makeSyntheticBoard(spec);
+    Benchmark::DenseSatelliteView view(*board, Position(-1, -1));
+    Algorithm::MyPlayer player(1, spec.width, spec.height, board->getMaxSteps(), 10);
+
+    vector<Position> tankPositions;
+    vector<unique_ptr<Algorithm::TankAlgorithm_A>> tanks;
+    for (const auto &[player_idx, tank_idx, tank_pos] : board->getTanks())
+    {
+        if (player_idx != 1)
+            continue;
+        tankPositions.push_back(tank_pos);
+        tanks.push_back(make_unique<Algorithm::TankAlgorithm_A>(1, tank_idx));
+    }
+
+    BenchResult result;
+    result.spec = spec;
+    if (tanks.empty())
+        return result;
+
+    double totalNs = 0;
+    size_t allocsBefore = Benchmark::allocationCount(), bytesBefore = Benchmark::allocatedBytes();
+    while (result.actions < minActions || totalNs < minNs)
+    {
+        for (size_t i = 0; i < tanks.size(); ++i)
+        {
+            auto start = chrono::steady_clock::now();
+            ActionRequest action = tanks[i]->getAction();
+            if (action == ActionRequest::GetBattleInfo)
+            {
+                view.setTankPos(tankPositions[i]);
+                player.updateTankWithBattleInfo(*tanks[i], view);
+                ++result.battleInfos;
+            }
+            totalNs += Benchmark::elapsedNs(start);
+            ++result.actions;
+        }
+    }
+
+    result.nsPerAction = totalNs / result.actions;
+    result.allocsPerAction = double(Benchmark::allocationCount() - allocsBefore) / result.actions;
+    result.bytesPerAction = double(Benchmark::allocatedBytes() - bytesBefore) / result.actions;
+    result.peakRssKb = Benchmark::peakRssKb();
+    return result;
+}
+
+vector<size_t> parseSizes(const string &list)
+{
+    vector<size_t> sizes;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ','))
+        sizes.push_back(stoul(item));
+    return sizes;
+}
+
+void writeJson(const string &path, const vector<BenchResult> &results)
+{
+    ofstream out(path);
+    if (!out)
+    {
+        cerr << "Cannot create output file: " << path << "\n";
+        return;
+    }
+    out << "{\n  \"benchmark\": \"algorithm_bench\",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &r = results[i];
+        out << "    {\"width\": " << r.spec.width << ", \"height\": " << r.spec.height
+            << ", \"wall_density\": " << r.spec.wallDensity << ", \"shell_density\": " << r.spec.shellDensity
+            << ", \"tanks_per_player\": " << r.spec.tanksPerPlayer
+            << ", \"actions\": " << r.actions << ", \"battle_infos\": " << r.battleInfos
+            << ", \"ns_per_action\": " << fixed << setprecision(1) << r.nsPerAction
+            << ", \"allocs_per_action\": " << setprecision(3) << r.allocsPerAction
+            << ", \"bytes_per_action\": " << setprecision(1) << r.bytesPerAction
+            << ", \"peak_rss_kb\": " << r.peakRssKb << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+        out.unsetf(ios::floatfield);
+    }
+    out << "  ]\n}\n";
+}
+
+// Usage: algorithm_bench [sizes=20,50,...] [json=<file>] [min_actions=<n>] [-quick]
+// Runs a map size sweep at default densities, then wall / shell / tank density sweeps on a 200x200 map.
+int main(int argc, char *argv[])
+{
+    vector<size_t> sizes = {20, 50, 100, 200, 500, 1000, 2000};
+    string jsonPath;
+    size_t minActions = 200;
+    double minNs = 200e6;
+    bool densitySweeps = true;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "-quick")
+        {
+            minNs = 20e6;
+            minActions = 50;
+        }
+        else if (arg.rfind("sizes=", 0) == 0)
+        {
+            sizes = parseSizes(arg.substr(6));
+            densitySweeps = false;
+        }
+        else if (arg.rfind("json=", 0) == 0)
+            jsonPath = arg.substr(5);
+        else if (arg.rfind("min_actions=", 0) == 0)
+            minActions = stoul(arg.substr(12));
+        else
+        {
+            cerr << "Unsupported argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    vector<SyntheticBoardSpec> cases;
+    for (size_t size : sizes)
+    {
+        SyntheticBoardSpec spec;
+        spec.width = spec.height = size;
+        spec.tanksPerPlayer = max<size_t>(1, size / 20);
+        cases.push_back(spec);
+    }
+    if (densitySweeps)
+    {
+        SyntheticBoardSpec base;
+        base.width = base.height = 200;
+        base.tanksPerPlayer = 10;
+        for (double walls : {0.0, 0.3})
+        {
+            auto spec = base;
+            spec.wallDensity = walls;
+            cases.push_back(spec);
+        }
+        for (double shells : {0.0, 0.05})
+        {
+            auto spec = base;
+            spec.shellDensity = shells;
+            cases.push_back(spec);
+        }
+        for (size_t tanks : {1, 100})
+        {
+            auto spec = base;
+            spec.tanksPerPlayer = tanks;
+            cases.push_back(spec);
+        }
+    }
+
+    cout << setw(6) << "size" << setw(7) << "walls" << setw(7) << "shells" << setw(7) << "tanks"
+         << setw(10) << "actions" << setw(14) << "ns/action" << setw(14) << "allocs/action"
+         << setw(14) << "KB/action" << setw(14) << "peak RSS KB" << "\n";
+
+    vector<BenchResult> results;
+    for (const auto &spec : cases)
+    {
+        auto r = runCase(spec, minActions, minNs);
+        cout << setw(6) << spec.width << setw(7) << spec.wallDensity << setw(7) << spec.shellDensity
+             << setw(7) << spec.tanksPerPlayer << setw(10) << r.actions
+             << setw(14) << fixed << setprecision(0) << r.nsPerAction
+             << setw(14) << setprecision(2) << r.allocsPerAction
+             << setw(14) << r.bytesPerAction / 1024.0
+             << setw(14) << r.peakRssKb << "\n";
+        cout.unsetf(ios::floatfield);
+        results.push_back(r);
+    }
+
+    if (!jsonPath.empty())
+        writeJson(jsonPath, results);
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "AllocCounter.h"
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+namespace
+{
+    std::atomic<size_t> allocCount{0};
+    std::atomic<size_t> allocBytes{0};
+}
+
+namespace Benchmark
+{
+    size_t allocationCount() { return allocCount.load(std::memory_order_relaxed); }
+    size_t allocatedBytes() { return allocBytes.load(std::memory_order_relaxed); }
+}
+
+// GCC pairs the replacement operator delete with operator new and flags the free() as mismatched
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void *operator new(size_t size)
+{
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
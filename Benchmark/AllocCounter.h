@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+
+namespace Benchmark
+{
+    // Global operator new calls and bytes requested since the process started.
+    // Only binaries that link AllocCounter.cpp count; the counters are relaxed atomics.
+    size_t allocationCount();
+    size_t allocatedBytes();
+}
@@ -0,0 +1,65 @@
+#include "BenchSupport.h"
+#include "Algorithm/Player.h"
+#include "Algorithm/TankAlgorithm_A.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace UserCommon;
+using Benchmark::SyntheticBoardSpec;
+
+// Latency of one battle info round trip (MyPlayer decode + TankAlgorithm_A update) by map size.
+// The view is a flat grid, so the numbers cover the player side only.
+// Usage: battle_info_bench [size...]   sizes are square map edges, default 20..2000
+int main(int argc, char *argv[])
+{
+    vector<size_t> sizes = {20, 50, 100, 200, 500, 1000, 2000};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(stoul(argv[i]));
+    }
+
+    cout << setw(8) << "size" << setw(12) << "cells" << setw(10) << "iters"
+         << setw(16) << "ns/decode" << setw(12) << "ns/cell" << setw(14) << "ns/shared" << "\n";
+
+    for (size_t size : sizes)
+    {
+        SyntheticBoardSpec spec;
+        spec.width = spec.height = size;
+        spec.tanksPerPlayer = max<size_t>(1, size / 10);
+        auto board = Benchmark::makeSyntheticBoard(spec);
+
+        Benchmark::DenseSatelliteView view(*board, Benchmark::firstTankOf(*board, 1));
+        Algorithm::TankAlgorithm_A tank(1, 0);
+
+        // A new view is decoded; a tank whose view shows the same board shares the snapshot after checking it
+        auto measure = [&](bool freshRound)
+        {
+            Algorithm::MyPlayer player(1, size, size, board->getMaxSteps(), 10);
+            size_t iters = 0;
+            double totalNs = 0;
+            while (iters < 3 || totalNs < 250e6)
+            {
+                if (freshRound)
+                    player = Algorithm::MyPlayer(1, size, size, board->getMaxSteps(), 10);
+                auto start = chrono::steady_clock::now();
+                player.updateTankWithBattleInfo(tank, view);
+                totalNs += Benchmark::elapsedNs(start);
+                ++iters;
+            }
+            return make_pair(iters, totalNs / iters);
+        };
+
+        auto [iters, perDecode] = measure(true);
+        double perShared = measure(false).second;
+        cout << setw(8) << size << setw(12) << size * size << setw(10) << iters
+             << setw(16) << fixed << setprecision(0) << perDecode
+             << setw(12) << setprecision(2) << perDecode / double(size * size)
+             << setw(14) << setprecision(0) << perShared << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "BenchSupport.h"
+#include "UserCommon/Directions.h"
+#include <random>
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
+
+namespace Benchmark
+{
+    using namespace UserCommon;
+    using namespace std;
+
+    // Snapshot the board once with the same precedence SatelliteViewImpl uses
+    DenseSatelliteView::DenseSatelliteView(const GameBoard &board, Position tankPos)
+        : width(board.getWidth()), height(board.getHeight()), cells(board.getWidth() * board.getHeight(), ' ')
+    {
+        for (const auto &[player_idx, tank_idx, tank_pos] : board.getTanks())
+            cells[size_t(tank_pos.y) * width + tank_pos.x] = static_cast<char>('0' + player_idx);
+        for (const auto &mine : board.getMines())
+            cells[size_t(mine.y) * width + mine.x] = '@';
+        for (const auto &wall : board.getWalls())
+            cells[size_t(wall.y) * width + wall.x] = '#';
+        for (const auto &[shell_pos, shell_dir] : board.getShells())
+            cells[size_t(shell_pos.y) * width + shell_pos.x] = '*';
+        setTankPos(tankPos);
+    }
+
+    void DenseSatelliteView::setTankPos(Position pos)
+    {
+        if (tankPos.x >= 0 && tankPos.y >= 0)
+            cells[size_t(tankPos.y) * width + tankPos.x] = underTank;
+        tankPos = pos;
+        if (tankPos.x >= 0 && tankPos.y >= 0)
+        {
+            underTank = cells[size_t(tankPos.y) * width + tankPos.x];
+            cells[size_t(tankPos.y) * width + tankPos.x] = '%';
+        }
+    }
+
+    char DenseSatelliteView::getObjectAt(size_t x, size_t y) const
+    {
+        if (x >= width || y >= height)
+            return '&';
+        return cells[y * width + x];
+    }
+
+    unique_ptr<GameBoard> makeSyntheticBoard(const SyntheticBoardSpec &spec)
+    {
+        mt19937_64 rng(spec.seed);
+        uniform_real_distribution<double> coin(0.0, 1.0);
+        uniform_int_distribution<size_t> dirPick(0, 7);
+
+        set<Position> walls, mines;
+        vector<tuple<int, int, Position>> tanks;
+        vector<pair<Position, string>> shells;
+        size_t placed[2] = {0, 0};
+
+        for (size_t y = 0; y < spec.height; ++y)
+        {
+            for (size_t x = 0; x < spec.width; ++x)
+            {
+                Position p(static_cast<int>(x), static_cast<int>(y));
+                double roll = coin(rng);
+                if (roll < spec.wallDensity)
+                    walls.insert(p);
+                else if (roll < spec.wallDensity + spec.mineDensity)
+                    mines.insert(p);
+                else if (roll < spec.wallDensity + spec.mineDensity + spec.shellDensity)
+                    shells.emplace_back(p, Directions::directionOrder()[dirPick(rng)]);
+            }
+        }
+
+        // Tanks go on random free cells, alternating players
+        uniform_int_distribution<size_t> xPick(0, spec.width - 1), yPick(0, spec.height - 1);
+        set<Position> taken;
+        size_t attempts = 0;
+        while ((placed[0] < spec.tanksPerPlayer || placed[1] < spec.tanksPerPlayer) &&
+               attempts++ < 100 * (spec.tanksPerPlayer + 1) * 2)
+        {
+            Position p(static_cast<int>(xPick(rng)), static_cast<int>(yPick(rng)));
+            if (walls.count(p) || mines.count(p) || taken.count(p))
+                continue;
+            int player = placed[0] <= placed[1] ? 1 : 2;
+            tanks.emplace_back(player, static_cast<int>(placed[player - 1]), p);
+            placed[player - 1]++;
+            taken.insert(p);
+        }
+
+        auto board = make_unique<GameBoard>(spec.width, spec.height, size_t(1000), walls, mines, move(tanks));
+        for (auto &[pos, dir] : shells)
+        {
+            if (!taken.count(pos))
+                board->addShell(pos, dir);
+        }
+        return board;
+    }
+
+    // VmHWM is resettable through clear_refs; ru_maxrss is the fallback and only ever grows
+    long peakRssKb()
+    {
+        ifstream status("/proc/self/status");
+        string line;
+        while (getline(status, line))
+        {
+            if (line.rfind("VmHWM:", 0) == 0)
+                return stol(line.substr(6));
+        }
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    void resetPeakRss()
+    {
+        ofstream clearRefs("/proc/self/clear_refs");
+        if (clearRefs)
+            clearRefs << "5";
+    }
+
+    Position firstTankOf(const GameBoard &board, int playerIndex)
+    {
+        for (const auto &[player_idx, tank_idx, tank_pos] : board.getTanks())
+        {
+            if (player_idx == playerIndex)
+                return tank_pos;
+        }
+        return Position(-1, -1);
+    }
+}
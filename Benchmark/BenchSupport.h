@@ -0,0 +1,55 @@
+#pragma once
+#include "UserCommon/GameBoard.h"
+#include "common/SatelliteView.h"
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Benchmark
+{
+
+    // Shape of a generated board; densities are per-cell probabilities
+    struct SyntheticBoardSpec
+    {
+        size_t width = 20, height = 20;
+        double wallDensity = 0.1;
+        double mineDensity = 0.02;
+        double shellDensity = 0.01;
+        size_t tanksPerPlayer = 2;
+        uint64_t seed = 1;
+    };
+
+    // Satellite view over a flat char grid, so measurements exclude the game manager's view lookups
+    class DenseSatelliteView : public SatelliteView
+    {
+    private:
+        size_t width, height;
+        std::vector<char> cells;
+        UserCommon::Position tankPos;
+        char underTank = ' ';
+
+    public:
+        DenseSatelliteView(const UserCommon::GameBoard &board, UserCommon::Position tankPos);
+        char getObjectAt(size_t x, size_t y) const override;
+
+        // Move the '%' marker to the tank that is asking next
+        void setTankPos(UserCommon::Position pos);
+    };
+
+    // Random board in memory, the same for the same spec
+    std::unique_ptr<UserCommon::GameBoard> makeSyntheticBoard(const SyntheticBoardSpec &spec);
+
+    // Position of the first tank of a player on the board, (-1,-1) if none
+    UserCommon::Position firstTankOf(const UserCommon::GameBoard &board, int playerIndex);
+
+    // Peak resident set size of the process in KB, and a reset of that peak where the kernel allows it
+    long peakRssKb();
+    void resetPeakRss();
+
+    inline double elapsedNs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+}
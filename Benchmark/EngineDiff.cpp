@@ -0,0 +1,716 @@
+#include "BenchSupport.h"
+#include "PerfCounters.h"
+#include "common/AbstractGameManager.h"
+#include "common/GameManagerRegistration.h"
+#include "common/GameResult.h"
+#include "common/Player.h"
+#include "common/TankAlgorithm.h"
+#include "UserCommon/GameBoard.h"
+#include "UserCommon/SatelliteViewImpl.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <map>
+#include <dlfcn.h>
+#include <unistd.h>
+
+// Differential check of two game manager builds: a reference and an optimized candidate play the same
+// maps with the same scripted action streams, and the canonical state dumps both publish through
+// tankgame_set_step_observer are compared after every step, together with the battle info views the
+// tanks were given during it and, at the end, the final game state. The first divergence stops the run
+// and is written out as a minimized reproduction; without one, both builds are timed per phase.
+
+using namespace std;
+using namespace UserCommon;
+namespace fs = std::filesystem;
+
+using StepObserver = void (*)(void *context, size_t step, const char *state, size_t length);
+using SetStepObserver = void (*)(StepObserver observer, void *context, bool withState);
+
+// A game manager plugin registers while it is loaded, so this holds the factory of the last one loaded
+static GameManagerFactory registeredFactory;
+GameManagerRegistration::GameManagerRegistration(GameManagerFactory factory) { registeredFactory = std::move(factory); }
+
+// One game manager build, loaded from a private copy so that two builds of one file stay separate
+struct Engine
+{
+    string name;
+    GameManagerFactory factory;
+    SetStepObserver setObserver = nullptr;
+};
+
+Engine loadEngine(const string &path, const string &name, const fs::path &work)
+{
+    fs::path copy = work / (name + ".so");
+    fs::copy_file(path, copy, fs::copy_options::overwrite_existing);
+    registeredFactory = nullptr;
+    void *handle = dlopen(copy.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle)
+        throw runtime_error("Failed to load " + path + ": " + dlerror());
+    if (!registeredFactory)
+        throw runtime_error(path + " did not register a game manager");
+
+    Engine engine;
+    engine.name = name;
+    engine.factory = registeredFactory;
+    engine.setObserver = reinterpret_cast<SetStepObserver>(dlsym(handle, "tankgame_set_step_observer"));
+    if (!engine.setObserver)
+        throw runtime_error(path + " does not export tankgame_set_step_observer");
+    return engine;
+}
+
+// Actions of every tank by (player, tank index), one per turn it is asked; DoNothing once they run out
+using ActionScript = map<pair<int, int>, vector<ActionRequest>>;
+
+const vector<pair<ActionRequest, string>> &actionNames()
+{
+    static const vector<pair<ActionRequest, string>> names = {
+        {ActionRequest::MoveForward, "MoveForward"}, {ActionRequest::MoveBackward, "MoveBackward"},
+        {ActionRequest::RotateLeft90, "RotateLeft90"}, {ActionRequest::RotateRight90, "RotateRight90"},
+        {ActionRequest::RotateLeft45, "RotateLeft45"}, {ActionRequest::RotateRight45, "RotateRight45"},
+        {ActionRequest::Shoot, "Shoot"}, {ActionRequest::GetBattleInfo, "GetBattleInfo"}, {ActionRequest::DoNothing, "DoNothing"}};
+    return names;
+}
+
+class ScriptedTank : public TankAlgorithm
+{
+private:
+    const vector<ActionRequest> *actions;
+    size_t next = 0;
+
+public:
+    explicit ScriptedTank(const vector<ActionRequest> *actions) : actions(actions) {}
+    ActionRequest getAction() override { return actions && next < actions->size() ? (*actions)[next++] : ActionRequest::DoNothing; }
+    void updateBattleInfo(BattleInfo &) override {}
+};
+
+// Every cell of a view, one row per line, including the row and column just past the map
+string renderView(const SatelliteView &view, size_t width, size_t height)
+{
+    string text;
+    for (size_t y = 0; y <= height; ++y)
+    {
+        for (size_t x = 0; x <= width; ++x)
+            text += view.getObjectAt(x, y);
+        text += "\n";
+    }
+    return text;
+}
+
+// Scripted tanks ignore what they are told, so the action streams cannot depend on the engine; the
+// views are only written down, if views is set, to be compared with the state of the step
+class ScriptedPlayer : public Player
+{
+private:
+    size_t width, height;
+    string *views;
+
+public:
+    ScriptedPlayer(size_t width, size_t height, string *views) : width(width), height(height), views(views) {}
+
+    void updateTankWithBattleInfo(TankAlgorithm &, SatelliteView &view) override
+    {
+        if (views)
+            *views += "view\n" + renderView(view, width, height);
+    }
+};
+
+// Mostly moves and shots, so that tanks meet, walls break and shells cross
+ActionScript randomScript(uint64_t seed, size_t tanksPerPlayer, size_t turns)
+{
+    static const ActionRequest weighted[] = {
+        ActionRequest::MoveForward, ActionRequest::MoveForward, ActionRequest::MoveForward, ActionRequest::MoveForward,
+        ActionRequest::Shoot, ActionRequest::Shoot, ActionRequest::Shoot, ActionRequest::MoveBackward,
+        ActionRequest::RotateLeft45, ActionRequest::RotateRight45, ActionRequest::RotateLeft90, ActionRequest::RotateRight90,
+        ActionRequest::DoNothing, ActionRequest::GetBattleInfo};
+    mt19937_64 rng(seed);
+    uniform_int_distribution<size_t> pick(0, size(weighted) - 1);
+    ActionScript script;
+    for (int player = 1; player <= 2; ++player)
+    {
+        for (size_t tank = 1; tank <= tanksPerPlayer; ++tank)
+        {
+            auto &actions = script[{player, static_cast<int>(tank)}];
+            for (size_t turn = 0; turn < turns; ++turn)
+                actions.push_back(weighted[pick(rng)]);
+        }
+    }
+    return script;
+}
+
+// One line per tank that acts: player, tank index, then its actions in turn order
+void writeScript(const ActionScript &script, const string &path)
+{
+    ofstream out(path);
+    for (const auto &[tank, actions] : script)
+    {
+        if (actions.empty())
+            continue;
+        out << tank.first << " " << tank.second;
+        for (ActionRequest action : actions)
+        {
+            for (const auto &[value, name] : actionNames())
+            {
+                if (value == action)
+                    out << " " << name;
+            }
+        }
+        out << "\n";
+    }
+}
+
+ActionScript readScript(const string &path)
+{
+    ifstream in(path);
+    if (!in)
+        throw runtime_error("Cannot read action script " + path);
+    ActionScript script;
+    string line;
+    while (getline(in, line))
+    {
+        istringstream fields(line);
+        int player = 0, tank = 0;
+        if (!(fields >> player >> tank))
+            continue;
+        auto &actions = script[{player, tank}];
+        for (string word; fields >> word;)
+        {
+            auto it = find_if(actionNames().begin(), actionNames().end(), [&word](const auto &entry)
+                              { return entry.second == word; });
+            if (it == actionNames().end())
+                throw runtime_error("Unknown action " + word + " in " + path);
+            actions.push_back(it->first);
+        }
+    }
+    return script;
+}
+
+// In the map file format the simulator reads; tanks are numbered by the same scan in both engines
+void writeMap(const GameBoard &board, size_t maxSteps, size_t numShells, const string &path)
+{
+    vector<string> rows(board.getHeight(), string(board.getWidth(), ' '));
+    for (const auto &wall : board.getWalls())
+        rows[wall.y][wall.x] = '#';
+    for (const auto &mine : board.getMines())
+        rows[mine.y][mine.x] = '@';
+    for (const auto &[player, tank, pos] : board.getTanks())
+        rows[pos.y][pos.x] = static_cast<char>('0' + player);
+
+    ofstream out(path);
+    out << "engine_diff reproduction\n"
+        << "MaxSteps = " << maxSteps << "\n"
+        << "NumShells = " << numShells << "\n"
+        << "Rows = " << board.getHeight() << "\n"
+        << "Cols = " << board.getWidth() << "\n";
+    for (const auto &row : rows)
+        out << row << "\n";
+}
+
+struct Scenario
+{
+    string label;
+    unique_ptr<GameBoard> board;
+    size_t maxSteps = 0;
+    size_t numShells = 0;
+    ActionScript script;
+};
+
+// The state after setup and after every step, as the engine dumped it, after the views of that step
+struct Trace
+{
+    vector<string> states;
+    string views; // given out since the last state
+    string finalState;
+    int winner = -1;
+    int reason = 0;
+    size_t rounds = 0;
+};
+
+GameResult playScenario(const Engine &engine, const Scenario &scenario, string *views = nullptr)
+{
+    auto tankFactory = [&scenario](int player, int tank) -> unique_ptr<TankAlgorithm>
+    {
+        auto it = scenario.script.find({player, tank});
+        return make_unique<ScriptedTank>(it == scenario.script.end() ? nullptr : &it->second);
+    };
+    ScriptedPlayer player1(scenario.board->getWidth(), scenario.board->getHeight(), views);
+    ScriptedPlayer player2(scenario.board->getWidth(), scenario.board->getHeight(), views);
+    SatelliteViewImpl view(*scenario.board, Position(-1, -1));
+    auto gm = engine.factory(false);
+    return gm->run(scenario.board->getWidth(), scenario.board->getHeight(), view, scenario.label,
+                   scenario.maxSteps, scenario.numShells, player1, "script_1", player2, "script_2", tankFactory, tankFactory);
+}
+
+void recordState(void *context, size_t, const char *state, size_t length)
+{
+    Trace &trace = *static_cast<Trace *>(context);
+    trace.states.push_back(trace.views + string(state, length));
+    trace.views.clear();
+}
+
+Trace observe(const Engine &engine, const Scenario &scenario)
+{
+    Trace trace;
+    engine.setObserver(recordState, &trace, true);
+    GameResult result = playScenario(engine, scenario, &trace.views);
+    engine.setObserver(nullptr, nullptr, false);
+    if (result.gameState)
+        trace.finalState = renderView(*result.gameState, scenario.board->getWidth(), scenario.board->getHeight());
+    trace.winner = result.winner;
+    trace.reason = result.reason;
+    trace.rounds = result.rounds;
+    return trace;
+}
+
+uint64_t fnv1a(const string &text)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text)
+        hash = (hash ^ c) * 1099511628211ULL;
+    return hash;
+}
+
+struct Divergence
+{
+    bool found = false;
+    size_t step = 0; // states after this many steps differ; step 0 is the state after setup
+    string reference, candidate;
+};
+
+// Per-step hashes decide; a game that ends earlier in one engine diverges where the other goes on
+Divergence compareTraces(const Trace &reference, const Trace &candidate)
+{
+    Divergence divergence;
+    size_t common = min(reference.states.size(), candidate.states.size());
+    for (size_t step = 0; step < common; ++step)
+    {
+        if (fnv1a(reference.states[step]) != fnv1a(candidate.states[step]))
+        {
+            divergence = {true, step, reference.states[step], candidate.states[step]};
+            return divergence;
+        }
+    }
+    if (reference.states.size() != candidate.states.size())
+    {
+        divergence.found = true;
+        divergence.step = common;
+        divergence.reference = common < reference.states.size() ? reference.states[common] : "(game over)\n";
+        divergence.candidate = common < candidate.states.size() ? candidate.states[common] : "(game over)\n";
+    }
+    else if (reference.winner != candidate.winner || reference.reason != candidate.reason || reference.rounds != candidate.rounds ||
+             reference.finalState != candidate.finalState)
+    {
+        divergence.found = true;
+        divergence.step = common;
+        auto describe = [](const Trace &trace)
+        { return "result winner " + to_string(trace.winner) + " reason " + to_string(trace.reason) + " rounds " + to_string(trace.rounds) + "\n" + trace.finalState; };
+        divergence.reference = describe(reference);
+        divergence.candidate = describe(candidate);
+    }
+    return divergence;
+}
+
+Divergence diverges(const Engine &reference, const Engine &candidate, const Scenario &scenario)
+{
+    return compareTraces(observe(reference, scenario), observe(candidate, scenario));
+}
+
+// Greedy reduction of the action script: turns after the divergence are dropped, then every action
+// that can be replaced by DoNothing while the engines still disagree is, latest first
+size_t minimizeScript(const Engine &reference, const Engine &candidate, Scenario &scenario, Divergence &divergence, size_t budget)
+{
+    size_t tries = 0;
+    size_t turns = divergence.step / 2 + 1;
+    ActionScript trimmed = scenario.script;
+    for (auto &[tank, actions] : trimmed)
+        actions.resize(min(actions.size(), turns));
+    swap(scenario.script, trimmed);
+    Divergence found = diverges(reference, candidate, scenario);
+    tries++;
+    if (!found.found)
+        swap(scenario.script, trimmed);
+    else
+        divergence = found;
+
+    for (auto &[tank, actions] : scenario.script)
+    {
+        for (size_t i = actions.size(); i-- > 0 && tries < budget;)
+        {
+            if (actions[i] == ActionRequest::DoNothing)
+                continue;
+            ActionRequest original = actions[i];
+            actions[i] = ActionRequest::DoNothing;
+            found = diverges(reference, candidate, scenario);
+            tries++;
+            if (found.found)
+                divergence = found;
+            else
+                actions[i] = original;
+        }
+        while (!actions.empty() && actions.back() == ActionRequest::DoNothing)
+            actions.pop_back();
+    }
+    return tries;
+}
+
+// The dump lines that differ, marked - for the reference and + for the candidate
+string differingLines(const string &reference, const string &candidate)
+{
+    auto lines = [](const string &text)
+    {
+        vector<string> out;
+        istringstream in(text);
+        for (string line; getline(in, line);)
+            out.push_back(line);
+        return out;
+    };
+    vector<string> a = lines(reference), b = lines(candidate);
+    ostringstream out;
+    for (size_t i = 0; i < max(a.size(), b.size()); ++i)
+    {
+        string left = i < a.size() ? a[i] : "", right = i < b.size() ? b[i] : "";
+        if (left == right)
+            continue;
+        if (!left.empty())
+            out << "- " << left << "\n";
+        if (!right.empty())
+            out << "+ " << right << "\n";
+    }
+    return out.str();
+}
+
+// Per-phase wall time of one engine: setup until the first step, steps in which tanks act, steps in
+// which only shells move, and building the result after the last step
+struct PhaseTimes
+{
+    double setupMs = 0, tankStepsMs = 0, shellStepsMs = 0, finishMs = 0;
+    double totalMs() const { return setupMs + tankStepsMs + shellStepsMs + finishMs; }
+};
+
+void markStep(void *context, size_t, const char *, size_t)
+{
+    static_cast<vector<chrono::steady_clock::time_point> *>(context)->push_back(chrono::steady_clock::now());
+}
+
+void timeScenario(const Engine &engine, const Scenario &scenario, PhaseTimes &times)
+{
+    vector<chrono::steady_clock::time_point> marks;
+    marks.reserve(2 * scenario.maxSteps + 2);
+    engine.setObserver(markStep, &marks, false);
+    auto start = chrono::steady_clock::now();
+    playScenario(engine, scenario);
+    auto end = chrono::steady_clock::now();
+    engine.setObserver(nullptr, nullptr, false);
+    if (marks.empty())
+        return;
+
+    auto ms = [](chrono::steady_clock::time_point from, chrono::steady_clock::time_point to)
+    { return chrono::duration<double, milli>(to - from).count(); };
+    times.setupMs += ms(start, marks[0]);
+    for (size_t step = 1; step < marks.size(); ++step)
+        (step % 2 == 1 ? times.tankStepsMs : times.shellStepsMs) += ms(marks[step - 1], marks[step]);
+    times.finishMs += ms(marks.back(), end);
+}
+
+// Hardware counters of one engine by phase, summed over games, with what they are divided by when reported
+struct PhaseCounters
+{
+    Benchmark::PerfCounters::Sample setup, tankSteps, shellSteps, result, game;
+    size_t games = 0, tankStepCount = 0, shellStepCount = 0;
+};
+
+struct CounterMarks
+{
+    const Benchmark::PerfCounters *counters;
+    vector<Benchmark::PerfCounters::Sample> samples;
+};
+
+void sampleStep(void *context, size_t, const char *, size_t)
+{
+    auto *marks = static_cast<CounterMarks *>(context);
+    marks->samples.push_back(marks->counters->read());
+}
+
+// A pass of its own, as reading the counters after every step would show up in the timed pass
+void countScenario(const Engine &engine, const Scenario &scenario, const Benchmark::PerfCounters &counters, PhaseCounters &phases)
+{
+    CounterMarks marks{&counters, {}};
+    marks.samples.reserve(2 * scenario.maxSteps + 2);
+    engine.setObserver(sampleStep, &marks, false);
+    Benchmark::PerfCounters::Sample start = counters.read();
+    playScenario(engine, scenario);
+    Benchmark::PerfCounters::Sample end = counters.read();
+    engine.setObserver(nullptr, nullptr, false);
+    if (marks.samples.empty())
+        return;
+
+    phases.setup += marks.samples[0] - start;
+    for (size_t step = 1; step < marks.samples.size(); ++step)
+    {
+        bool tankStep = step % 2 == 1;
+        (tankStep ? phases.tankSteps : phases.shellSteps) += marks.samples[step] - marks.samples[step - 1];
+        (tankStep ? phases.tankStepCount : phases.shellStepCount)++;
+    }
+    phases.result += end - marks.samples.back();
+    phases.game += end - start;
+    phases.games++;
+}
+
+// Parsing the map files, which is the same for both engines; generated maps are written out to be parsed
+Benchmark::PerfCounters::Sample countMapParsing(const vector<Scenario> &scenarios, const Benchmark::PerfCounters &counters, const fs::path &work)
+{
+    Benchmark::PerfCounters::Sample total;
+    for (size_t i = 0; i < scenarios.size(); ++i)
+    {
+        string file = (work / ("parse_" + to_string(i) + ".txt")).string();
+        writeMap(*scenarios[i].board, scenarios[i].maxSteps, scenarios[i].numShells, file);
+        Benchmark::PerfCounters::Sample before = counters.read();
+        GameBoard parsed(file);
+        total += counters.read() - before;
+    }
+    return total;
+}
+
+void printCounters(const Benchmark::PerfCounters &counters, const Benchmark::PerfCounters::Sample &mapParsing, size_t maps,
+                   const PhaseCounters &reference, const PhaseCounters &candidate)
+{
+    using Benchmark::PerfCounters;
+    cout << "\nHardware counters, user space";
+    if (!counters.unavailableReason().empty())
+        cout << "; some are missing: " << counters.unavailableReason();
+    cout << "\n"
+         << setw(12) << left << "phase" << setw(11) << "engine" << setw(7) << "per" << right;
+    for (size_t c = 0; c < PerfCounters::COUNTER_COUNT; ++c)
+        cout << setw(15) << PerfCounters::name(static_cast<PerfCounters::Counter>(c));
+    cout << setw(8) << "IPC" << "\n";
+
+    auto row = [&counters](const string &phase, const string &engine, const char *per, const PerfCounters::Sample &sample, size_t count)
+    {
+        cout << setw(12) << left << phase << setw(11) << engine << setw(7) << per << right << fixed << setprecision(0);
+        for (size_t c = 0; c < PerfCounters::COUNTER_COUNT; ++c)
+        {
+            if (counters.has(static_cast<PerfCounters::Counter>(c)) && count > 0)
+                cout << setw(15) << sample.values[c] / count;
+            else
+                cout << setw(15) << "n/a";
+        }
+        double cycles = sample.values[PerfCounters::CYCLES];
+        if (counters.has(PerfCounters::CYCLES) && counters.has(PerfCounters::INSTRUCTIONS) && cycles > 0)
+            cout << setw(8) << setprecision(2) << sample.values[PerfCounters::INSTRUCTIONS] / cycles << "\n";
+        else
+            cout << setw(8) << "n/a" << "\n";
+    };
+
+    row("map parse", "", "map", mapParsing, maps);
+    for (const auto &[engine, phases] : {pair<string, const PhaseCounters *>{"reference", &reference}, {"candidate", &candidate}})
+    {
+        row("setup", engine, "game", phases->setup, phases->games);
+        row("tank step", engine, "step", phases->tankSteps, phases->tankStepCount);
+        row("shell step", engine, "step", phases->shellSteps, phases->shellStepCount);
+        row("finish", engine, "game", phases->result, phases->games);
+        row("game", engine, "game", phases->game, phases->games);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    fs::path root = fs::canonical("/proc/self/exe").parent_path().parent_path();
+    string referencePath, candidatePath = (root / "GameManager" / "GameManager.so").string();
+    string mapPath, scriptPath;
+    fs::path reproDir = root / "Benchmark" / "engine_diff_repro";
+    Benchmark::SyntheticBoardSpec spec;
+    spec.shellDensity = 0; // map files cannot hold shells, so a reproduction would start differently
+    size_t games = 50, maxSteps = 200, numShells = 16, repeats = 3, minimizeBudget = 2000;
+    uint64_t seed = 1;
+    bool withCounters = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg.rfind("reference=", 0) == 0)
+            referencePath = arg.substr(10);
+        else if (arg.rfind("candidate=", 0) == 0)
+            candidatePath = arg.substr(10);
+        else if (arg.rfind("games=", 0) == 0)
+            games = max<size_t>(1, stoul(arg.substr(6)));
+        else if (arg.rfind("seed=", 0) == 0)
+            seed = stoull(arg.substr(5));
+        else if (arg.rfind("width=", 0) == 0)
+            spec.width = max<size_t>(2, stoul(arg.substr(6)));
+        else if (arg.rfind("height=", 0) == 0)
+            spec.height = max<size_t>(2, stoul(arg.substr(7)));
+        else if (arg.rfind("tanks=", 0) == 0)
+            spec.tanksPerPlayer = max<size_t>(1, stoul(arg.substr(6)));
+        else if (arg.rfind("walls=", 0) == 0)
+            spec.wallDensity = stod(arg.substr(6));
+        else if (arg.rfind("mines=", 0) == 0)
+            spec.mineDensity = stod(arg.substr(6));
+        else if (arg.rfind("max_steps=", 0) == 0)
+            maxSteps = stoul(arg.substr(10));
+        else if (arg.rfind("num_shells=", 0) == 0)
+            numShells = stoul(arg.substr(11));
+        else if (arg.rfind("map=", 0) == 0)
+            mapPath = arg.substr(4);
+        else if (arg.rfind("script=", 0) == 0)
+            scriptPath = arg.substr(7);
+        else if (arg.rfind("repro=", 0) == 0)
+            reproDir = arg.substr(6);
+        else if (arg.rfind("repeats=", 0) == 0)
+            repeats = stoul(arg.substr(8));
+        else if (arg.rfind("minimize=", 0) == 0)
+            minimizeBudget = stoul(arg.substr(9));
+        else if (arg == "-counters")
+            withCounters = true;
+        else
+        {
+            cerr << "Unsupported argument: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (referencePath.empty())
+    {
+        cerr << "usage: engine_diff reference=<GameManager.so> [candidate=<GameManager.so>] [games=] [seed=] [width=] [height=]\n"
+                "                   [tanks=] [walls=] [mines=] [max_steps=] [num_shells=] [map=<file> [script=<file>]]\n"
+                "                   [repro=<dir>] [repeats=] [minimize=] [-counters]\n";
+        return 1;
+    }
+
+    fs::path work = fs::temp_directory_path() / ("engine_diff_" + to_string(getpid()));
+    int exitCode = 0;
+    try
+    {
+        fs::create_directories(work);
+        Engine reference = loadEngine(referencePath, "reference", work);
+        Engine candidate = loadEngine(candidatePath, "candidate", work);
+
+        // A given map plays once, with the given script or a random one; otherwise every game has its own generated map
+        vector<Scenario> scenarios;
+        for (size_t g = 0; g < (mapPath.empty() ? games : 1); ++g)
+        {
+            Scenario scenario;
+            if (!mapPath.empty())
+            {
+                scenario.board = make_unique<GameBoard>(mapPath);
+                if (!scenario.board->isValid())
+                    throw runtime_error("Invalid map " + mapPath);
+                scenario.label = fs::path(mapPath).stem().string();
+                scenario.maxSteps = scenario.board->getMaxSteps();
+                scenario.numShells = scenario.board->getNumShells();
+            }
+            else
+            {
+                spec.seed = seed + g;
+                scenario.board = Benchmark::makeSyntheticBoard(spec);
+                scenario.label = "generated_" + to_string(spec.seed);
+                scenario.maxSteps = maxSteps;
+                scenario.numShells = numShells;
+            }
+            size_t tanks = max(spec.tanksPerPlayer, scenario.board->getTanks().size());
+            scenario.script = scriptPath.empty() ? randomScript(seed + g, tanks, scenario.maxSteps) : readScript(scriptPath);
+            scenarios.push_back(std::move(scenario));
+        }
+
+        size_t steps = 0;
+        for (auto &scenario : scenarios)
+        {
+            Trace referenceTrace = observe(reference, scenario);
+            Divergence divergence = compareTraces(referenceTrace, observe(candidate, scenario));
+            steps += referenceTrace.states.size();
+            if (!divergence.found)
+                continue;
+
+            cout << "Divergence on " << scenario.label << " after " << divergence.step << " steps:\n"
+                 << differingLines(divergence.reference, divergence.candidate);
+            size_t tries = minimizeScript(reference, candidate, scenario, divergence, minimizeBudget);
+            size_t actions = 0;
+            for (const auto &[tank, list] : scenario.script)
+                actions += count_if(list.begin(), list.end(), [](ActionRequest a)
+                                    { return a != ActionRequest::DoNothing; });
+
+            fs::create_directories(reproDir);
+            writeMap(*scenario.board, scenario.maxSteps, scenario.numShells, (reproDir / "map.txt").string());
+            writeScript(scenario.script, (reproDir / "actions.txt").string());
+            ofstream((reproDir / "divergence.txt").string())
+                << "after " << divergence.step << " steps\n--- reference\n" << divergence.reference << "--- candidate\n" << divergence.candidate;
+            cout << "Minimized in " << tries << " runs to " << actions << " actions, diverging after " << divergence.step << " steps.\n"
+                 << "Reproduction in " << reproDir.string() << "; replay with:\n  " << argv[0] << " reference=" << referencePath
+                 << " candidate=" << candidatePath << " map=" << (reproDir / "map.txt").string()
+                 << " script=" << (reproDir / "actions.txt").string() << "\n";
+            exitCode = 2;
+            break;
+        }
+
+        if (exitCode == 0)
+        {
+            cout << "No divergence in " << scenarios.size() << " games, " << steps << " states compared.\n";
+
+            // Alternating which engine goes first, so neither always runs on a warm cache
+            PhaseTimes referenceTimes, candidateTimes;
+            for (size_t r = 0; r < repeats; ++r)
+            {
+                for (const auto &scenario : scenarios)
+                {
+                    if (r % 2 == 0)
+                    {
+                        timeScenario(reference, scenario, referenceTimes);
+                        timeScenario(candidate, scenario, candidateTimes);
+                    }
+                    else
+                    {
+                        timeScenario(candidate, scenario, candidateTimes);
+                        timeScenario(reference, scenario, referenceTimes);
+                    }
+                }
+            }
+
+            if (repeats > 0)
+            {
+                cout << setw(14) << left << "phase" << right << setw(16) << "reference ms" << setw(16) << "candidate ms" << setw(10) << "speedup" << "\n";
+                auto row = [](const string &phase, double referenceMs, double candidateMs)
+                {
+                    cout << setw(14) << left << phase << right << fixed << setprecision(2) << setw(16) << referenceMs << setw(16) << candidateMs
+                         << setw(9) << (candidateMs > 0 ? referenceMs / candidateMs : 0) << "x\n";
+                };
+                row("setup", referenceTimes.setupMs, candidateTimes.setupMs);
+                row("tank steps", referenceTimes.tankStepsMs, candidateTimes.tankStepsMs);
+                row("shell steps", referenceTimes.shellStepsMs, candidateTimes.shellStepsMs);
+                row("finish", referenceTimes.finishMs, candidateTimes.finishMs);
+                row("total", referenceTimes.totalMs(), candidateTimes.totalMs());
+            }
+
+            if (withCounters)
+            {
+                Benchmark::PerfCounters counters;
+                if (!counters.available())
+                {
+                    cout << "\nHardware counters are unavailable: " << counters.unavailableReason() << "\n";
+                }
+                else
+                {
+                    Benchmark::PerfCounters::Sample mapParsing = countMapParsing(scenarios, counters, work);
+                    PhaseCounters referenceCounters, candidateCounters;
+                    for (const auto &scenario : scenarios)
+                    {
+                        countScenario(reference, scenario, counters, referenceCounters);
+                        countScenario(candidate, scenario, counters, candidateCounters);
+                    }
+                    printCounters(counters, mapParsing, scenarios.size(), referenceCounters, candidateCounters);
+                }
+            }
+        }
+    }
+    catch (const exception &e)
+    {
+        cerr << "Error: " << e.what() << "\n";
+        exitCode = 1;
+    }
+    fs::remove_all(work);
+    return exitCode;
+}
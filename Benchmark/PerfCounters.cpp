@@ -0,0 +1,115 @@
+#include "PerfCounters.h"
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    int openCounter(uint64_t config, int groupFd)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    std::string explain(int error)
+    {
+        if (error == EACCES || error == EPERM)
+        {
+            std::ifstream in("/proc/sys/kernel/perf_event_paranoid");
+            std::string level;
+            in >> level;
+            return "not permitted (kernel.perf_event_paranoid = " + (level.empty() ? std::string("?") : level) + ")";
+        }
+        if (error == ENOENT || error == EOPNOTSUPP || error == ENODEV)
+            return "not supported here (no hardware PMU, e.g. in a VM or container)";
+        if (error == ENOSYS)
+            return "perf_event_open is not available in this kernel";
+        return std::strerror(error);
+    }
+}
+
+namespace Benchmark
+{
+    PerfCounters::Sample &PerfCounters::Sample::operator+=(const Sample &other)
+    {
+        for (size_t i = 0; i < COUNTER_COUNT; ++i)
+            values[i] += other.values[i];
+        return *this;
+    }
+
+    PerfCounters::Sample PerfCounters::Sample::operator-(const Sample &other) const
+    {
+        Sample difference;
+        for (size_t i = 0; i < COUNTER_COUNT; ++i)
+            difference.values[i] = values[i] - other.values[i];
+        return difference;
+    }
+
+    PerfCounters::PerfCounters()
+    {
+        static const uint64_t configs[COUNTER_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        int firstError = 0;
+        for (size_t i = 0; i < COUNTER_COUNT; ++i)
+        {
+            // The first counter that opens leads the group, so one missing counter does not lose the others
+            int fd = openCounter(configs[i], leader);
+            if (fd < 0)
+            {
+                if (firstError == 0)
+                    firstError = errno;
+                continue;
+            }
+            if (leader < 0)
+                leader = fd;
+            fds[i] = fd;
+            slots[i] = opened++;
+        }
+        if (firstError != 0)
+            reason = explain(firstError);
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+        for (int fd : fds)
+        {
+            if (fd >= 0)
+                close(fd);
+        }
+    }
+
+    PerfCounters::Sample PerfCounters::read() const
+    {
+        Sample sample;
+        if (leader < 0)
+            return sample;
+
+        // nr, time enabled, time running, then one value per counter in opening order
+        uint64_t data[3 + COUNTER_COUNT] = {};
+        if (::read(leader, data, sizeof(data)) < static_cast<ssize_t>(3 * sizeof(uint64_t)))
+            return sample;
+        double scale = data[2] == 0 ? 0 : static_cast<double>(data[1]) / data[2];
+        for (size_t i = 0; i < COUNTER_COUNT; ++i)
+        {
+            if (fds[i] >= 0 && slots[i] < data[0])
+                sample.values[i] = static_cast<double>(data[3 + slots[i]]) * scale;
+        }
+        return sample;
+    }
+
+    const char *PerfCounters::name(Counter counter)
+    {
+        static const char *names[COUNTER_COUNT] = {"cycles", "instructions", "LLC misses", "branch misses"};
+        return names[counter];
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Benchmark
+{
+    // User-space hardware counters of the calling thread, read with one perf_event_open group.
+    // Opening never fails: counters the kernel does not permit or the CPU (or VM) does not have
+    // are left out, and unavailableReason() says why.
+    class PerfCounters
+    {
+    public:
+        enum Counter
+        {
+            CYCLES,
+            INSTRUCTIONS,
+            LLC_MISSES,
+            BRANCH_MISSES,
+            COUNTER_COUNT
+        };
+
+        // Counts since the group was opened, scaled up if the kernel multiplexed it
+        struct Sample
+        {
+            double values[COUNTER_COUNT] = {};
+
+            Sample &operator+=(const Sample &other);
+            Sample operator-(const Sample &other) const;
+        };
+
+    private:
+        int leader = -1;
+        int fds[COUNTER_COUNT] = {-1, -1, -1, -1};
+        size_t slots[COUNTER_COUNT] = {}; // position of each open counter in the group's read
+        size_t opened = 0;
+        std::string reason;
+
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        bool available() const { return opened > 0; }
+        bool has(Counter counter) const { return fds[counter] >= 0; }
+        const std::string &unavailableReason() const { return reason; }
+
+        // One read() of the whole group; all zero if nothing is open
+        Sample read() const;
+
+        static const char *name(Counter counter);
+    };
+}
@@ -0,0 +1,7 @@
+#include "common/PlayerRegistration.h"
+#include "common/TankAlgorithmRegistration.h"
+
+// The benchmarks link the algorithm sources directly, so the registration hooks the
+// simulator normally provides are no-ops here.
+PlayerRegistration::PlayerRegistration(PlayerFactory) {}
+TankAlgorithmRegistration::TankAlgorithmRegistration(TankAlgorithmFactory) {}
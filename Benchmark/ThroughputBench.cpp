@@ -0,0 +1,438 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// One mode at one thread count, over the repeats of that configuration
+struct ThroughputResult
+{
+    string mode;
+    int threads = 1;
+    size_t games = 0;
+    double seconds = 0; // median wall time of a repeat
+    double gamesPerSec = 0;
+    double p50Ms = -1, p99Ms = -1; // per game, competition mode only
+    double efficiency = 1;         // games/sec relative to threads x the single-thread rate
+    long peakRssKb = 0;
+};
+
+struct ProcessRun
+{
+    double seconds = 0;
+    long peakRssKb = 0;
+    bool ok = false;
+};
+
+// Run a program with its output going to logPath; wall time and peak RSS come from the kernel's accounting of the child
+ProcessRun runProcess(const vector<string> &args, const string &logPath)
+{
+    ProcessRun run;
+    auto start = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0)
+        return run;
+    if (pid == 0)
+    {
+        int fd = open(logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        vector<char *> argv;
+        for (const auto &arg : args)
+            argv.push_back(const_cast<char *>(arg.c_str()));
+        argv.push_back(nullptr);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0)
+        return run;
+    run.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    run.peakRssKb = usage.ru_maxrss;
+    run.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    return run;
+}
+
+void copyFile(const fs::path &from, const fs::path &to)
+{
+    fs::copy_file(from, to, fs::copy_options::overwrite_existing);
+}
+
+// Fixed-seed corpus: square maps of a few sizes, rotationally symmetric so both seats are equal
+vector<string> generateMaps(const fs::path &root, const fs::path &folder, size_t count, size_t maxSteps)
+{
+    static const size_t sizes[] = {12, 20, 28, 36};
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    vector<string> maps;
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t size = sizes[i % 4];
+        string file = (folder / ("map_" + to_string(i) + ".txt")).string();
+        vector<string> args = {(root / "MapGenerator" / "map_generator").string(), "output=" + file,
+                               "rows=" + to_string(size), "cols=" + to_string(size), "tanks=" + to_string(1 + i % 3),
+                               "walls=0.12", "mines=0.03", "symmetry=rotate", "max_steps=" + to_string(maxSteps),
+                               "num_shells=20", "seed=" + to_string(1000 + i)};
+        if (!runProcess(args, (folder / "generator.log").string()).ok)
+            throw runtime_error("map_generator failed for " + file);
+        maps.push_back(file);
+    }
+    fs::remove(folder / "generator.log");
+    return maps;
+}
+
+// time_ms of every line of a results_log file
+vector<double> readGameTimes(const string &path)
+{
+    vector<double> times;
+    ifstream in(path);
+    string line;
+    while (getline(in, line))
+    {
+        size_t pos = line.find("\"time_ms\": ");
+        if (pos != string::npos)
+            times.push_back(stod(line.substr(pos + 11)));
+    }
+    return times;
+}
+
+double percentile(vector<double> values, double p)
+{
+    if (values.empty())
+        return -1;
+    sort(values.begin(), values.end());
+    size_t index = min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5));
+    return values[index];
+}
+
+struct Workspace
+{
+    fs::path root, work, simulator, algorithms, gameManagers, gameManager;
+    vector<string> maps;
+};
+
+ThroughputResult runCompetition(const Workspace &ws, int threads, int repeats)
+{
+    ThroughputResult result;
+    result.mode = "competition";
+    result.threads = threads;
+
+    vector<double> wallTimes, gameTimes;
+    string resultsLog = (ws.work / "results.jsonl").string();
+    for (int r = 0; r < repeats; ++r)
+    {
+        vector<string> args = {ws.simulator.string(), "-competition", "game_maps_folder=" + (ws.work / "maps").string(),
+                               "game_manager=" + ws.gameManager.string(), "algorithms_folder=" + ws.algorithms.string(),
+                               "num_threads=" + to_string(threads), "round_robin=full", "results_log=" + resultsLog};
+        ProcessRun run = runProcess(args, (ws.work / "simulator.log").string());
+        if (!run.ok)
+            throw runtime_error("simulator failed, see " + (ws.work / "simulator.log").string());
+        vector<double> times = readGameTimes(resultsLog);
+        result.games = times.size();
+        gameTimes.insert(gameTimes.end(), times.begin(), times.end());
+        wallTimes.push_back(run.seconds);
+        result.peakRssKb = max(result.peakRssKb, run.peakRssKb);
+        for (const auto &entry : fs::directory_iterator(ws.algorithms))
+        {
+            if (entry.path().extension() == ".txt")
+                fs::remove(entry.path());
+        }
+    }
+
+    sort(wallTimes.begin(), wallTimes.end());
+    result.seconds = wallTimes[wallTimes.size() / 2];
+    result.gamesPerSec = result.games / result.seconds;
+    result.p50Ms = percentile(gameTimes, 0.50);
+    result.p99Ms = percentile(gameTimes, 0.99);
+    return result;
+}
+
+// Comparative mode plays one map under every game manager, so every map is one simulator run
+ThroughputResult runComparative(const Workspace &ws, int threads, int repeats)
+{
+    ThroughputResult result;
+    result.mode = "comparative";
+    result.threads = threads;
+
+    size_t managers = 0;
+    for (const auto &entry : fs::directory_iterator(ws.gameManagers))
+        managers += entry.path().extension() == ".so";
+
+    vector<double> wallTimes;
+    for (int r = 0; r < repeats; ++r)
+    {
+        double seconds = 0;
+        for (const auto &map : ws.maps)
+        {
+            vector<string> args = {ws.simulator.string(), "-comparative", "game_map=" + map,
+                                   "game_managers_folder=" + ws.gameManagers.string(),
+                                   "algorithm1=" + (ws.algorithms / "Alg_0.so").string(),
+                                   "algorithm2=" + (ws.algorithms / "Alg_1.so").string(),
+                                   "num_threads=" + to_string(threads)};
+            ProcessRun run = runProcess(args, (ws.work / "simulator.log").string());
+            if (!run.ok)
+                throw runtime_error("simulator failed, see " + (ws.work / "simulator.log").string());
+            seconds += run.seconds;
+            result.peakRssKb = max(result.peakRssKb, run.peakRssKb);
+        }
+        wallTimes.push_back(seconds);
+        for (const auto &entry : fs::directory_iterator(ws.gameManagers))
+        {
+            if (entry.path().extension() == ".txt")
+                fs::remove(entry.path());
+        }
+    }
+
+    sort(wallTimes.begin(), wallTimes.end());
+    result.games = managers * ws.maps.size();
+    result.seconds = wallTimes[wallTimes.size() / 2];
+    result.gamesPerSec = result.games / result.seconds;
+    return result;
+}
+
+void writeJson(ostream &out, const Workspace &ws, const vector<ThroughputResult> &results)
+{
+    out << "{\n  \"benchmark\": \"throughput_bench\",\n  \"cpus\": " << thread::hardware_concurrency()
+        << ",\n  \"maps\": " << ws.maps.size() << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &r = results[i];
+        out << "    {\"mode\": \"" << r.mode << "\", \"threads\": " << r.threads << ", \"games\": " << r.games
+            << fixed << setprecision(3) << ", \"seconds\": " << r.seconds
+            << ", \"games_per_sec\": " << r.gamesPerSec
+            << ", \"p50_ms\": " << r.p50Ms << ", \"p99_ms\": " << r.p99Ms
+            << ", \"efficiency\": " << r.efficiency
+            << ", \"peak_rss_kb\": " << r.peakRssKb << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+        out.unsetf(ios::floatfield);
+    }
+    out << "  ]\n}\n";
+}
+
+// Value of "key": in a result line written by writeJson, -1 if absent
+double jsonNumber(const string &line, const string &key)
+{
+    size_t pos = line.find("\"" + key + "\": ");
+    if (pos == string::npos)
+        return -1;
+    return stod(line.substr(pos + key.size() + 4));
+}
+
+string jsonString(const string &line, const string &key)
+{
+    size_t pos = line.find("\"" + key + "\": \"");
+    if (pos == string::npos)
+        return "";
+    pos += key.size() + 5;
+    return line.substr(pos, line.find('"', pos) - pos);
+}
+
+// Compare with a JSON file from an earlier run; a result counts as a regression when it is worse than the
+// baseline result of the same mode and thread count by more than tolerance (a fraction)
+size_t compareWithBaseline(const string &path, const vector<ThroughputResult> &results, double tolerance)
+{
+    ifstream in(path);
+    if (!in)
+        throw runtime_error("Cannot read baseline " + path);
+
+    size_t regressions = 0;
+    string line;
+    while (getline(in, line))
+    {
+        string mode = jsonString(line, "mode");
+        if (mode.empty())
+            continue;
+        int threads = static_cast<int>(jsonNumber(line, "threads"));
+        auto current = find_if(results.begin(), results.end(), [&](const ThroughputResult &r)
+                               { return r.mode == mode && r.threads == threads; });
+        if (current == results.end())
+            continue;
+
+        auto check = [&](const char *metric, double baseline, double now, bool higherIsBetter)
+        {
+            if (baseline <= 0 || now < 0)
+                return;
+            double change = (now - baseline) / baseline;
+            bool worse = higherIsBetter ? change < -tolerance : change > tolerance;
+            cout << (worse ? "REGRESSION " : "           ") << setw(12) << left << mode << right
+                 << " threads=" << setw(3) << threads << " " << setw(14) << left << metric << right
+                 << fixed << setprecision(2) << setw(12) << baseline << " -> " << setw(12) << now
+                 << " (" << showpos << setprecision(1) << change * 100 << "%)" << noshowpos << "\n";
+            cout.unsetf(ios::floatfield);
+            regressions += worse;
+        };
+        check("games/sec", jsonNumber(line, "games_per_sec"), current->gamesPerSec, true);
+        check("p99 ms", jsonNumber(line, "p99_ms"), current->p99Ms, false);
+        check("peak RSS KB", jsonNumber(line, "peak_rss_kb"), static_cast<double>(current->peakRssKb), false);
+    }
+    return regressions;
+}
+
+vector<int> parseThreads(const string &list)
+{
+    vector<int> threads;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ','))
+        threads.push_back(stoi(item));
+    return threads;
+}
+
+// Thread counts 1, 4, 8, ... up to the number of CPUs, and the CPU count itself. The simulator never
+// runs exactly 2 threads, so 2 is left out.
+vector<int> defaultThreads()
+{
+    int cpus = max(1, static_cast<int>(thread::hardware_concurrency()));
+    vector<int> threads = {1};
+    for (int t = 4; t < cpus; t *= 2)
+        threads.push_back(t);
+    if (cpus > 2)
+        threads.push_back(cpus);
+    return threads;
+}
+
+// Usage: throughput_bench [threads=1,4,...] [json=<file>] [baseline=<file>] [tolerance=<percent>]
+//                         [repeats=<n>] [maps=<n>] [algorithms=<n>] [game_managers=<n>] [work=<dir>] [-quick]
+// Runs the simulator built in this tree on a generated map corpus in competition and comparative mode
+// at every thread count. With baseline=, exits with 2 if any result regressed by more than tolerance.
+int main(int argc, char *argv[])
+{
+    fs::path root = fs::canonical("/proc/self/exe").parent_path().parent_path();
+    vector<int> threads = defaultThreads();
+    string jsonPath, baselinePath;
+    double tolerance = 0.10;
+    int repeats = 3;
+    size_t mapCount = 8, algorithmCount = 4, managerCount = 4, maxSteps = 300;
+    fs::path work = root / "Benchmark" / "throughput_work";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "-quick")
+        {
+            repeats = 1;
+            mapCount = 4;
+            maxSteps = 100;
+        }
+        else if (arg.rfind("threads=", 0) == 0)
+            threads = parseThreads(arg.substr(8));
+        else if (arg.rfind("json=", 0) == 0)
+            jsonPath = arg.substr(5);
+        else if (arg.rfind("baseline=", 0) == 0)
+            baselinePath = arg.substr(9);
+        else if (arg.rfind("tolerance=", 0) == 0)
+            tolerance = stod(arg.substr(10)) / 100;
+        else if (arg.rfind("repeats=", 0) == 0)
+            repeats = max(1, stoi(arg.substr(8)));
+        else if (arg.rfind("maps=", 0) == 0)
+            mapCount = stoul(arg.substr(5));
+        else if (arg.rfind("algorithms=", 0) == 0)
+            algorithmCount = max<size_t>(2, stoul(arg.substr(11)));
+        else if (arg.rfind("game_managers=", 0) == 0)
+            managerCount = max<size_t>(1, stoul(arg.substr(14)));
+        else if (arg.rfind("work=", 0) == 0)
+            work = arg.substr(5);
+        else
+        {
+            cerr << "Unsupported argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    try
+    {
+        Workspace ws;
+        ws.root = root;
+        ws.work = work;
+        ws.simulator = root / "Simulator" / "simulator";
+        ws.algorithms = work / "algorithms";
+        ws.gameManagers = work / "game_managers";
+        ws.gameManager = work / "GameManager.so";
+        for (const auto &artifact : {ws.simulator, root / "Algorithm" / "Algorithm.so", root / "GameManager" / "GameManager.so",
+                                     root / "MapGenerator" / "map_generator"})
+        {
+            if (!fs::exists(artifact))
+                throw runtime_error(artifact.string() + " is missing; run make first");
+        }
+
+        // The simulator loads every .so in a folder, so the in-tree plugins are copied under distinct names
+        fs::create_directories(work);
+        fs::remove_all(ws.algorithms);
+        fs::remove_all(ws.gameManagers);
+        fs::create_directories(ws.algorithms);
+        fs::create_directories(ws.gameManagers);
+        for (size_t i = 0; i < algorithmCount; ++i)
+            copyFile(root / "Algorithm" / "Algorithm.so", ws.algorithms / ("Alg_" + to_string(i) + ".so"));
+        for (size_t i = 0; i < managerCount; ++i)
+            copyFile(root / "GameManager" / "GameManager.so", ws.gameManagers / ("GM_" + to_string(i) + ".so"));
+        copyFile(root / "GameManager" / "GameManager.so", ws.gameManager);
+        ws.maps = generateMaps(root, work / "maps", mapCount, maxSteps);
+
+        cout << setw(12) << left << "mode" << right << setw(8) << "threads" << setw(8) << "games" << setw(10) << "seconds"
+             << setw(11) << "games/sec" << setw(10) << "p50 ms" << setw(10) << "p99 ms" << setw(11) << "efficiency"
+             << setw(14) << "peak RSS KB" << "\n";
+
+        vector<ThroughputResult> results;
+        for (const char *mode : {"competition", "comparative"})
+        {
+            double singleThreadRate = 0;
+            for (int t : threads)
+            {
+                ThroughputResult r = string(mode) == "competition" ? runCompetition(ws, t, repeats) : runComparative(ws, t, repeats);
+                if (t == 1)
+                    singleThreadRate = r.gamesPerSec;
+                r.efficiency = singleThreadRate > 0 ? r.gamesPerSec / (singleThreadRate * t) : -1;
+                cout << setw(12) << left << r.mode << right << setw(8) << r.threads << setw(8) << r.games
+                     << fixed << setprecision(2) << setw(10) << r.seconds << setw(11) << r.gamesPerSec
+                     << setw(10) << r.p50Ms << setw(10) << r.p99Ms << setw(11) << r.efficiency
+                     << setw(14) << r.peakRssKb << "\n";
+                cout.unsetf(ios::floatfield);
+                results.push_back(r);
+            }
+        }
+
+        if (!jsonPath.empty())
+        {
+            ofstream out(jsonPath);
+            if (!out)
+                throw runtime_error("Cannot create output file: " + jsonPath);
+            writeJson(out, ws, results);
+        }
+        if (!baselinePath.empty())
+        {
+            cout << "\nCompared with " << baselinePath << " (tolerance " << tolerance * 100 << "%):\n";
+            size_t regressions = compareWithBaseline(baselinePath, results, tolerance);
+            if (regressions > 0)
+            {
+                cout << regressions << " regressions.\n";
+                return 2;
+            }
+            cout << "No regressions.\n";
+        }
+    }
+    catch (const exception &e)
+    {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
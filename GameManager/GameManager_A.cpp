@@ -2,10 +2,12 @@
 #include <iostream>
 #include <vector>
 #include "TankState.h"
+#include "SmallMapEngine.h"
 #include "UserCommon/Directions.h"
 #include "UserCommon/SatelliteViewImpl.h"
 #include "common/GameManagerRegistration.h"
 #include <sstream>
+#include <algorithm>
 
 namespace GameManager
 {
@@ -30,6 +32,41 @@ namespace GameManager
         return true;
     }
 
+    // Everything the rules depend on, in an order that does not depend on how it is stored: tanks by
+    // player and index, shells by position, wall hits by position, and what is left of walls and mines
+    std::string GameManager_A::stateDump() const
+    {
+        std::ostringstream out;
+        out << "step " << stepCount << " ammo_end " << stepsSinceAmmoEnd << "\n";
+
+        std::vector<TankState *> tanks;
+        for (const auto &tank : tankStates)
+            tanks.push_back(tank.get());
+        std::sort(tanks.begin(), tanks.end(), [](TankState *a, TankState *b)
+                  { return std::make_pair(a->getPlayerIdx(), a->getTankIdx()) < std::make_pair(b->getPlayerIdx(), b->getTankIdx()); });
+        for (TankState *tank : tanks)
+        {
+            out << "tank " << tank->getPlayerIdx() << " " << tank->getTankIdx() << " " << tank->getPosition().x << " " << tank->getPosition().y
+                << " " << tank->getDirection() << " alive " << tank->isAlive() << " ammo " << tank->getAmmo()
+                << " cooldown " << tank->getCooldown() << " backward " << tank->getBackwardWait() << " " << tank->isPendingBackward() << "\n";
+        }
+
+        std::vector<std::pair<Position, std::string>> shells = board.getShells();
+        std::sort(shells.begin(), shells.end());
+        for (const auto &[pos, dir] : shells)
+            out << "shell " << pos.x << " " << pos.y << " " << dir << "\n";
+        for (const auto &[pos, hits] : board.getWeakenedWalls())
+            out << "wall_hit " << pos.x << " " << pos.y << " " << hits << "\n";
+        out << "walls " << board.getWalls().size() << " mines " << board.getMines().size() << "\n";
+        return out.str();
+    }
+
+    void GameManager_A::notifyStepObserver() const
+    {
+        if (hasStepObserver())
+            reportStep(stepCount, stepObserverWantsState() ? stateDump() : std::string());
+    }
+
     std::string ActionToString(ActionRequest action)
     {
         switch (action)
@@ -525,6 +562,15 @@ namespace GameManager
                 throw runtime_error("Failed to open output file: " + file_name.str());
             }
         }
+        if (map_width <= SmallMapEngine<64>::MAX_WIDTH && map_height <= 64 && map_width > 0 && map_height > 0)
+        {
+            GameResult result = runSmallMap(map_width, map_height, map, max_steps, num_shells, player1, player2,
+                                            player1_tank_algo_factory, player2_tank_algo_factory);
+            this->maxSteps = 0;
+            output_file.close();
+            return result;
+        }
+
         set<Position> walls;
         set<Position> mines;
         vector<tuple<int, int, Position>> tanks;
@@ -571,6 +617,7 @@ namespace GameManager
         }
         GameBoard board_(map_width, map_height, max_steps, walls, mines, move(tanks));
         board = move(board_);
+        notifyStepObserver();
 
         while (!isGameOver())
         {
@@ -607,6 +654,7 @@ namespace GameManager
                 tank->setWasKilledThisRound(false);
                 tank->setActionIgnored(false);
             }
+            notifyStepObserver();
         }
 
         GameResult result;
@@ -680,6 +728,22 @@ namespace GameManager
         return result;
     }
 
+    // Maps of up to 64x64 run on bit-planes sized for their height class; the rules are the same
+    GameResult GameManager_A::runSmallMap(size_t map_width, size_t map_height, const SatelliteView &map,
+                                          size_t max_steps, size_t num_shells, Player &player1, Player &player2,
+                                          TankAlgorithmFactory &player1_tank_algo_factory,
+                                          TankAlgorithmFactory &player2_tank_algo_factory)
+    {
+        if (map_height <= 16)
+            return SmallMapEngine<16>(map_width, map_height, max_steps, STEPSAFTERAMMOENDS, output_file)
+                .run(map, num_shells, player1, player2, player1_tank_algo_factory, player2_tank_algo_factory);
+        if (map_height <= 32)
+            return SmallMapEngine<32>(map_width, map_height, max_steps, STEPSAFTERAMMOENDS, output_file)
+                .run(map, num_shells, player1, player2, player1_tank_algo_factory, player2_tank_algo_factory);
+        return SmallMapEngine<64>(map_width, map_height, max_steps, STEPSAFTERAMMOENDS, output_file)
+            .run(map, num_shells, player1, player2, player1_tank_algo_factory, player2_tank_algo_factory);
+    }
+
     std::unique_ptr<AbstractGameManager> createGameManager(bool verbose)
     {
         return std::make_unique<GameManager_A>(verbose);
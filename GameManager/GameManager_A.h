@@ -4,6 +4,7 @@
 #include "common/Player.h"
 #include "common/TankAlgorithm.h"
 #include "TankState.h"
+#include "StepObserver.h"
 #include "UserCommon/GameBoard.h"
 #include "common/GameManagerRegistration.h"
 #include <memory>
@@ -43,6 +44,12 @@ namespace GameManager
         bool isGameOver() const;
         void printGameResult() const;
         bool isFree(const UserCommon::Position &pos) const;
+        std::string stateDump() const;
+        void notifyStepObserver() const;
+        GameResult runSmallMap(size_t map_width, size_t map_height, const SatelliteView &map,
+                               size_t max_steps, size_t num_shells, Player &player1, Player &player2,
+                               TankAlgorithmFactory &player1_tank_algo_factory,
+                               TankAlgorithmFactory &player2_tank_algo_factory);
 
         size_t stepCount, stepsSinceAmmoEnd, maxSteps;
         UserCommon::GameBoard &board;
@@ -55,4 +62,8 @@ namespace GameManager
         size_t STEPSAFTERAMMOENDS = 40;
     };
 
-}
\ No newline at end of file
+    std::string ActionToString(ActionRequest action);
+    std::string join(const std::vector<std::string> &items, const std::string &delimiter);
+
+}
+
@@ -0,0 +1,568 @@
+#include "SmallMapEngine.h"
+#include "GameManager_A.h"
+#include "StepObserver.h"
+#include "UserCommon/Position.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace GameManager
+{
+    namespace
+    {
+        // Offsets and names in the order of Directions::directionOrder(); the opposite of d is d + 4
+        constexpr int DX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+        constexpr int DY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+        const char *const DIRECTION_NAMES[8] = {"U", "UR", "R", "DR", "D", "DL", "L", "UL"};
+    }
+
+    template <size_t Rows>
+    char BitPlaneView<Rows>::getObjectAt(size_t x, size_t y) const
+    {
+        if (y > height || x > width)
+            return '&';
+        if (static_cast<int>(x) == tankX && static_cast<int>(y) == tankY)
+            return '%';
+        if (x >= width || y >= height)
+            return ' ';
+        uint64_t bit = uint64_t(1) << x;
+        if (shells[y] & bit)
+            return '*';
+        if (walls[y] & bit)
+            return '#';
+        if (mines[y] & bit)
+            return '@';
+        if (tanks1[y] & bit)
+            return '1';
+        if (tanks2[y] & bit)
+            return '2';
+        return ' ';
+    }
+
+    template <size_t Rows>
+    SmallMapEngine<Rows>::SmallMapEngine(size_t width, size_t height, size_t maxSteps, size_t stepsAfterAmmoEnds, std::ofstream &log)
+        : width(width), height(height), maxSteps(maxSteps), stepsAfterAmmoEnds(stepsAfterAmmoEnds),
+          w(static_cast<int>(width)), h(static_cast<int>(height)), log(log)
+    {
+        if (width == 0 || height == 0 || width > MAX_WIDTH || height > Rows)
+            throw std::invalid_argument("SmallMapEngine: map of " + std::to_string(width) + "x" + std::to_string(height) +
+                                        " does not fit " + std::to_string(MAX_WIDTH) + "x" + std::to_string(Rows));
+    }
+
+    template <size_t Rows>
+    BitPlane<Rows> SmallMapEngine<Rows>::shellPlane() const
+    {
+        BitPlane<Rows> plane{};
+        for (const Shell &shell : shells)
+            set(plane, shell.x, shell.y);
+        return plane;
+    }
+
+    template <size_t Rows>
+    std::unique_ptr<BitPlaneView<Rows>> SmallMapEngine<Rows>::view(int tankX, int tankY, const BitPlane<Rows> *tankPlanes) const
+    {
+        return std::make_unique<BitPlaneView<Rows>>(width, height, shellPlane(), walls, mines, tankPlanes[0], tankPlanes[1], tankX, tankY);
+    }
+
+    // Same rules, in the same order, as GameManager_A::applyActionToTank
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::applyActionToTank(Tank &tank, ActionRequest action, Player &p, TankAlgorithm &algorithm)
+    {
+        int back = (tank.dir + 4) % 8;
+        if (action == ActionRequest::MoveForward)
+        {
+            tank.lastAction = ActionRequest::MoveForward;
+            uint8_t x = wrapX(tank.x + DX[tank.dir]), y = wrapY(tank.y + DY[tank.dir]);
+            if (tank.pendingBackward)
+            {
+                tank.pendingBackward = false;
+                tank.backwardWait = 0;
+            }
+            else if (!test(walls, x, y))
+            {
+                tank.x = x;
+                tank.y = y;
+            }
+            else
+            {
+                tank.ignored = true;
+            }
+        }
+        if (tank.pendingBackward && tank.backwardWait == 2)
+        {
+            tank.lastAction = action;
+            uint8_t x = wrapX(tank.x + DX[back]), y = wrapY(tank.y + DY[back]);
+            if (!test(walls, x, y))
+            {
+                tank.x = x;
+                tank.y = y;
+                tank.pendingBackward = false;
+                if (action != ActionRequest::MoveBackward)
+                    tank.ignored = true;
+            }
+            else
+            {
+                tank.ignored = true;
+            }
+        }
+        else if (action == ActionRequest::MoveBackward)
+        {
+            tank.lastAction = ActionRequest::MoveBackward;
+            if (!tank.pendingBackward && tank.backwardWait >= 2)
+            {
+                uint8_t x = wrapX(tank.x + DX[back]), y = wrapY(tank.y + DY[back]);
+                if (!test(walls, x, y))
+                {
+                    tank.x = x;
+                    tank.y = y;
+                }
+                else
+                {
+                    tank.ignored = true;
+                }
+            }
+            else
+            {
+                if (tank.backwardWait != 0)
+                    tank.ignored = true;
+                tank.pendingBackward = true;
+                tank.backwardWait++;
+            }
+        }
+        else if (action == ActionRequest::RotateLeft45 || action == ActionRequest::RotateRight45 ||
+                 action == ActionRequest::RotateLeft90 || action == ActionRequest::RotateRight90 ||
+                 action == ActionRequest::Shoot || action == ActionRequest::DoNothing ||
+                 action == ActionRequest::GetBattleInfo)
+        {
+            tank.lastAction = action;
+            if (tank.pendingBackward)
+            {
+                tank.ignored = true;
+                tank.backwardWait++;
+            }
+            else if (action == ActionRequest::Shoot)
+            {
+                if (tank.cooldown == 0 && tank.ammo > 0)
+                {
+                    shells.push_back({tank.x, tank.y, tank.dir});
+                    tank.cooldown = 4;
+                    tank.ammo--;
+                    tank.backwardWait = 0;
+                }
+                else
+                {
+                    tank.ignored = true;
+                }
+            }
+            else if (action == ActionRequest::GetBattleInfo)
+            {
+                auto battleInfo = view(tank.x, tank.y, startTanks);
+                p.updateTankWithBattleInfo(algorithm, *battleInfo);
+            }
+            else if (action != ActionRequest::DoNothing)
+            {
+                int turn = 2;
+                if (action == ActionRequest::RotateLeft45)
+                    turn = -1;
+                else if (action == ActionRequest::RotateRight45)
+                    turn = 1;
+                else if (action == ActionRequest::RotateLeft90)
+                    turn = -2;
+                tank.dir = static_cast<uint8_t>((tank.dir + turn + 8) % 8);
+                tank.backwardWait = 0;
+            }
+        }
+    }
+
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::moveShells()
+    {
+        prevShells = shells;
+        for (Shell &shell : shells)
+        {
+            shell.x = wrapX(shell.x + DX[shell.dir]);
+            shell.y = wrapY(shell.y + DY[shell.dir]);
+        }
+    }
+
+    // A wall goes on its second hit; the hit count stays for the state dump
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::shellHitWall()
+    {
+        size_t kept = 0;
+        for (const Shell &shell : shells)
+        {
+            if (!test(walls, shell.x, shell.y))
+            {
+                shells[kept++] = shell;
+                continue;
+            }
+            if (test(hitOnce, shell.x, shell.y))
+            {
+                reset(hitOnce, shell.x, shell.y);
+                set(hitTwice, shell.x, shell.y);
+                reset(walls, shell.x, shell.y);
+            }
+            else
+            {
+                set(hitOnce, shell.x, shell.y);
+            }
+        }
+        shells.resize(kept);
+    }
+
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::tankHitTank()
+    {
+        for (const Tank &tank : tanks)
+        {
+            if (!tank.alive)
+                continue;
+            if (test(seen, tank.x, tank.y))
+                set(repeated, tank.x, tank.y);
+            set(seen, tank.x, tank.y);
+        }
+        for (Tank &tank : tanks)
+        {
+            if (tank.alive && test(repeated, tank.x, tank.y))
+            {
+                tank.alive = false;
+                tank.killed = true;
+            }
+        }
+        for (const Tank &tank : tanks)
+            seen[tank.y] = repeated[tank.y] = 0;
+    }
+
+    // Dead tanks still set off mines, as in GameManager_A
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::tankHitMine()
+    {
+        for (Tank &tank : tanks)
+        {
+            if (test(mines, tank.x, tank.y))
+            {
+                reset(mines, tank.x, tank.y);
+                tank.alive = false;
+                tank.killed = true;
+            }
+        }
+    }
+
+    // A shell kills the first live tank in its cell; the plane only skips cells without one
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::shellHitTank()
+    {
+        for (const Tank &tank : tanks)
+        {
+            if (tank.alive)
+                set(seen, tank.x, tank.y);
+        }
+        size_t kept = 0;
+        for (const Shell &shell : shells)
+        {
+            bool hitTank = false;
+            if (test(seen, shell.x, shell.y))
+            {
+                for (Tank &tank : tanks)
+                {
+                    if (tank.alive && tank.x == shell.x && tank.y == shell.y)
+                    {
+                        tank.alive = false;
+                        tank.killed = true;
+                        hitTank = true;
+                        break;
+                    }
+                }
+            }
+            if (!hitTank)
+                shells[kept++] = shell;
+        }
+        shells.resize(kept);
+        for (const Tank &tank : tanks)
+            seen[tank.y] = 0;
+    }
+
+    // Shells sharing a cell, or swapping cells, destroy each other. As in GameManager_A, shell i is
+    // checked for swapping against prevShells[i], the list before the wall and tank hits were removed.
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::shellHitShell()
+    {
+        size_t count = shells.size();
+        removed.assign(count, 0);
+        for (const Shell &shell : shells)
+        {
+            if (test(seen, shell.x, shell.y))
+                set(repeated, shell.x, shell.y);
+            set(seen, shell.x, shell.y);
+        }
+        for (size_t i = 0; i < count; ++i)
+            removed[i] = test(repeated, shells[i].x, shells[i].y);
+        for (const Shell &shell : shells)
+            seen[shell.y] = repeated[shell.y] = 0;
+
+        // Only a shell now in a cell some shell came from can have swapped
+        for (size_t i = 0; i < count; ++i)
+            set(seen, prevShells[i].x, prevShells[i].y);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!test(seen, shells[i].x, shells[i].y))
+                continue;
+            for (size_t j = i + 1; j < count; ++j)
+            {
+                if (prevShells[i].x == shells[j].x && prevShells[i].y == shells[j].y &&
+                    prevShells[j].x == shells[i].x && prevShells[j].y == shells[i].y)
+                {
+                    removed[i] = removed[j] = 1;
+                }
+            }
+        }
+        for (size_t i = 0; i < count; ++i)
+            seen[prevShells[i].y] = 0;
+
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!removed[i])
+                shells[kept++] = shells[i];
+        }
+        shells.resize(kept);
+    }
+
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::advanceStep(Player &p1, Player &p2)
+    {
+        if (stepCount % 2 == 0) // even steps → tanks act
+        {
+            bool isAmmoEnd = true;
+            for (size_t i = 0; i < tanks.size(); ++i)
+            {
+                Tank &tank = tanks[i];
+                if (!tank.alive)
+                    continue;
+                if (tank.cooldown > 0)
+                    tank.cooldown--;
+                if (tank.ammo > 0)
+                    isAmmoEnd = false;
+                actions[i] = algorithms[i]->getAction();
+            }
+            if (isAmmoEnd)
+                stepsSinceAmmoEnd++;
+
+            for (size_t i = 0; i < tanks.size(); ++i)
+            {
+                if (tanks[i].alive)
+                    applyActionToTank(tanks[i], actions[i], tanks[i].player == 1 ? p1 : p2, *algorithms[i]);
+            }
+
+            moveShells();
+            shellHitWall();
+            tankHitTank();
+            tankHitMine();
+            shellHitTank();
+            shellHitShell();
+        }
+        else // odd steps → only shells move
+        {
+            moveShells();
+            shellHitWall();
+            shellHitTank();
+            shellHitShell();
+        }
+    }
+
+    template <size_t Rows>
+    bool SmallMapEngine<Rows>::isGameOver() const
+    {
+        if (stepsSinceAmmoEnd >= stepsAfterAmmoEnds || stepCount >= maxSteps * 2)
+            return true;
+        bool player1 = false, player2 = false;
+        for (const Tank &tank : tanks)
+        {
+            if (tank.alive)
+            {
+                player1 |= tank.player == 1;
+                player2 |= tank.player == 2;
+            }
+        }
+        return !player1 || !player2;
+    }
+
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::logRound()
+    {
+        std::vector<std::string> roundLog;
+        for (const Tank &tank : tanks)
+        {
+            if (!tank.alive && !tank.killed)
+            {
+                roundLog.push_back("killed");
+                continue;
+            }
+            std::string actionStr = ActionToString(tank.lastAction);
+            if (tank.ignored)
+                actionStr += " (ignored)";
+            if (tank.killed)
+                actionStr += " (killed)";
+            roundLog.push_back(actionStr);
+        }
+        log << join(roundLog, ", ") << "\n";
+    }
+
+    // Same text as GameManager_A::stateDump for the same game
+    template <size_t Rows>
+    std::string SmallMapEngine<Rows>::stateDump() const
+    {
+        std::ostringstream out;
+        out << "step " << stepCount << " ammo_end " << stepsSinceAmmoEnd << "\n";
+
+        std::vector<const Tank *> sorted;
+        for (const Tank &tank : tanks)
+            sorted.push_back(&tank);
+        std::sort(sorted.begin(), sorted.end(), [](const Tank *a, const Tank *b)
+                  { return std::make_pair(a->player, a->idx) < std::make_pair(b->player, b->idx); });
+        for (const Tank *tank : sorted)
+        {
+            out << "tank " << tank->player << " " << tank->idx << " " << int(tank->x) << " " << int(tank->y)
+                << " " << DIRECTION_NAMES[tank->dir] << " alive " << tank->alive << " ammo " << tank->ammo
+                << " cooldown " << tank->cooldown << " backward " << tank->backwardWait << " " << tank->pendingBackward << "\n";
+        }
+
+        std::vector<Shell> ordered = shells;
+        std::sort(ordered.begin(), ordered.end(), [](const Shell &a, const Shell &b)
+                  {
+                      if (a.x != b.x || a.y != b.y)
+                          return std::make_pair(a.x, a.y) < std::make_pair(b.x, b.y);
+                      return std::strcmp(DIRECTION_NAMES[a.dir], DIRECTION_NAMES[b.dir]) < 0; });
+        for (const Shell &shell : ordered)
+            out << "shell " << int(shell.x) << " " << int(shell.y) << " " << DIRECTION_NAMES[shell.dir] << "\n";
+
+        size_t wallCount = 0, mineCount = 0;
+        for (size_t y = 0; y < height; ++y)
+        {
+            wallCount += std::popcount(walls[y]);
+            mineCount += std::popcount(mines[y]);
+        }
+        for (int x = 0; x < w; ++x)
+        {
+            for (int y = 0; y < h; ++y)
+            {
+                if (test(hitOnce, x, y) || test(hitTwice, x, y))
+                    out << "wall_hit " << x << " " << y << " " << (test(hitTwice, x, y) ? 2 : 1) << "\n";
+            }
+        }
+        out << "walls " << wallCount << " mines " << mineCount << "\n";
+        return out.str();
+    }
+
+    template <size_t Rows>
+    void SmallMapEngine<Rows>::notifyStepObserver() const
+    {
+        if (hasStepObserver())
+            reportStep(stepCount, stepObserverWantsState() ? stateDump() : std::string());
+    }
+
+    template <size_t Rows>
+    GameResult SmallMapEngine<Rows>::run(const SatelliteView &map, size_t num_shells, Player &player1, Player &player2,
+                                         TankAlgorithmFactory &player1_tank_algo_factory,
+                                         TankAlgorithmFactory &player2_tank_algo_factory)
+    {
+        // Same scan order as GameManager_A, so tanks are numbered and created in the same order
+        int p1tanks = 0, p2tanks = 0;
+        for (int x = 0; x < w; ++x)
+        {
+            for (int y = 0; y < h; ++y)
+            {
+                char obj = map.getObjectAt(x, y);
+                if (obj == '#')
+                    set(walls, x, y);
+                else if (obj == '@')
+                    set(mines, x, y);
+                else if (obj == '1' || obj == '2')
+                {
+                    Tank tank;
+                    tank.x = tank.startX = static_cast<uint8_t>(x);
+                    tank.y = tank.startY = static_cast<uint8_t>(y);
+                    tank.player = obj - '0';
+                    tank.idx = tank.player == 1 ? ++p1tanks : ++p2tanks;
+                    tank.dir = tank.player == 1 ? 6 : 2; // L : R
+                    tank.ammo = static_cast<int>(num_shells);
+                    tanks.push_back(tank);
+                    set(startTanks[tank.player - 1], x, y);
+                    algorithms.push_back(tank.player == 1 ? player1_tank_algo_factory(1, tank.idx)
+                                                          : player2_tank_algo_factory(2, tank.idx));
+                }
+            }
+        }
+        actions.resize(tanks.size());
+        // GameBoard sets these for the generic engine; UserCommon code running on this thread may use them
+        UserCommon::Position::width = w;
+        UserCommon::Position::height = h;
+        notifyStepObserver();
+
+        while (!isGameOver())
+        {
+            advanceStep(player1, player2);
+            if (stepCount % 2 == 0 && log.is_open())
+                logRound();
+            stepCount++;
+            for (Tank &tank : tanks)
+                tank.killed = tank.ignored = false;
+            notifyStepObserver();
+        }
+
+        GameResult result;
+        result.remaining_tanks.resize(2, 0);
+        // The final view shows the live tanks where they started, like the generic engine's board does
+        BitPlane<Rows> survivors[2]{};
+        for (const Tank &tank : tanks)
+        {
+            if (tank.alive)
+            {
+                result.remaining_tanks[tank.player - 1]++;
+                set(survivors[tank.player - 1], tank.startX, tank.startY);
+            }
+        }
+
+        if (result.remaining_tanks[0] > 0 && result.remaining_tanks[1] == 0)
+        {
+            result.winner = 1;
+            result.reason = GameResult::ALL_TANKS_DEAD;
+            log << "Player 1 won with " << result.remaining_tanks[0] << " tanks still alive" << "\n";
+        }
+        else if (result.remaining_tanks[1] > 0 && result.remaining_tanks[0] == 0)
+        {
+            result.winner = 2;
+            result.reason = GameResult::ALL_TANKS_DEAD;
+            log << "Player 2 won with " << result.remaining_tanks[1] << " tanks still alive" << "\n";
+        }
+        else if (result.remaining_tanks[0] == 0 && result.remaining_tanks[1] == 0)
+        {
+            result.winner = 0;
+            result.reason = GameResult::ALL_TANKS_DEAD;
+            log << "Tie, both players have zero tanks" << "\n";
+        }
+        else if (stepsSinceAmmoEnd >= stepsAfterAmmoEnds)
+        {
+            result.winner = 0;
+            result.reason = GameResult::ZERO_SHELLS;
+            log << "Tie, both players have zero shells for " << stepsAfterAmmoEnds << " steps" << "\n";
+        }
+        else
+        {
+            result.winner = 0;
+            result.reason = GameResult::MAX_STEPS;
+            log << "Tie, reached max steps = " << maxSteps << ", player 1 has " << result.remaining_tanks[0] << " tanks, player 2 has " << result.remaining_tanks[1] << " tanks" << "\n";
+        }
+
+        result.gameState = view(-1, -1, survivors);
+        result.rounds = stepCount / 2;
+        return result;
+    }
+
+    template class SmallMapEngine<16>;
+    template class SmallMapEngine<32>;
+    template class SmallMapEngine<64>;
+}
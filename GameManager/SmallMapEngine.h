@@ -0,0 +1,111 @@
+#pragma once
+#include "common/ActionRequest.h"
+#include "common/Player.h"
+#include "common/SatelliteView.h"
+#include "common/TankAlgorithm.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/GameResult.h"
+
+namespace GameManager
+{
+    // One bit per cell of a map of at most 64 columns: bit x of row y
+    template <size_t Rows>
+    using BitPlane = std::array<uint64_t, Rows>;
+
+    // A snapshot of a small map, answering like SatelliteViewImpl does for the same board
+    template <size_t Rows>
+    class BitPlaneView : public SatelliteView
+    {
+    private:
+        size_t width, height;
+        BitPlane<Rows> shells, walls, mines, tanks1, tanks2;
+        int tankX, tankY;
+
+    public:
+        BitPlaneView(size_t width, size_t height, const BitPlane<Rows> &shells, const BitPlane<Rows> &walls,
+                     const BitPlane<Rows> &mines, const BitPlane<Rows> &tanks1, const BitPlane<Rows> &tanks2,
+                     int tankX, int tankY)
+            : width(width), height(height), shells(shells), walls(walls), mines(mines),
+              tanks1(tanks1), tanks2(tanks2), tankX(tankX), tankY(tankY) {}
+
+        char getObjectAt(size_t x, size_t y) const override;
+    };
+
+    // GameManager_A's rules for maps of at most 64 columns and Rows rows. Walls, mines, wall hits and
+    // the tanks' start cells (which is where views show tanks) are bit-planes sized at compile time;
+    // tanks and shells stay in lists, since the rules resolve them in list order.
+    template <size_t Rows>
+    class SmallMapEngine
+    {
+    public:
+        static constexpr size_t MAX_WIDTH = 64;
+
+        // A game ends in a tie once no tank has had shells for stepsAfterAmmoEnds steps
+        SmallMapEngine(size_t width, size_t height, size_t maxSteps, size_t stepsAfterAmmoEnds, std::ofstream &log);
+
+        GameResult run(const SatelliteView &map, size_t num_shells, Player &player1, Player &player2,
+                       TankAlgorithmFactory &player1_tank_algo_factory,
+                       TankAlgorithmFactory &player2_tank_algo_factory);
+
+    private:
+        struct Tank
+        {
+            uint8_t x, y, dir, startX, startY;
+            int player, idx;
+            bool alive = true, pendingBackward = false;
+            int ammo, backwardWait = 0, cooldown = 0;
+            ActionRequest lastAction = ActionRequest::DoNothing;
+            bool ignored = false, killed = false;
+        };
+
+        struct Shell
+        {
+            uint8_t x, y, dir;
+        };
+
+        size_t width, height, maxSteps, stepsAfterAmmoEnds;
+        int w, h;
+        std::ofstream &log;
+        size_t stepCount = 0, stepsSinceAmmoEnd = 0;
+
+        BitPlane<Rows> walls{}, mines{}, hitOnce{}, hitTwice{};
+        BitPlane<Rows> startTanks[2]{};
+        std::vector<Tank> tanks;
+        std::vector<std::unique_ptr<TankAlgorithm>> algorithms;
+        std::vector<Shell> shells, prevShells;
+
+        // Scratch, left all zero between uses
+        BitPlane<Rows> seen{}, repeated{};
+        std::vector<ActionRequest> actions;
+        std::vector<char> removed;
+
+        static bool test(const BitPlane<Rows> &plane, int x, int y) { return (plane[y] >> x) & 1; }
+        static void set(BitPlane<Rows> &plane, int x, int y) { plane[y] |= uint64_t(1) << x; }
+        static void reset(BitPlane<Rows> &plane, int x, int y) { plane[y] &= ~(uint64_t(1) << x); }
+
+        uint8_t wrapX(int x) const { return static_cast<uint8_t>(x < 0 ? x + w : (x >= w ? x - w : x)); }
+        uint8_t wrapY(int y) const { return static_cast<uint8_t>(y < 0 ? y + h : (y >= h ? y - h : y)); }
+
+        BitPlane<Rows> shellPlane() const;
+        std::unique_ptr<BitPlaneView<Rows>> view(int tankX, int tankY, const BitPlane<Rows> *tankPlanes) const;
+
+        void applyActionToTank(Tank &tank, ActionRequest action, Player &p, TankAlgorithm &algorithm);
+        void moveShells();
+        void shellHitWall();
+        void tankHitTank();
+        void tankHitMine();
+        void shellHitTank();
+        void shellHitShell();
+        void advanceStep(Player &p1, Player &p2);
+        bool isGameOver() const;
+        void logRound();
+        std::string stateDump() const;
+        void notifyStepObserver() const;
+    };
+}
@@ -0,0 +1,27 @@
+#include "StepObserver.h"
+
+namespace
+{
+    thread_local TankGameStepObserver stepObserver = nullptr;
+    thread_local void *stepObserverContext = nullptr;
+    thread_local bool stepObserverState = false;
+}
+
+extern "C" void tankgame_set_step_observer(TankGameStepObserver observer, void *context, bool withState)
+{
+    stepObserver = observer;
+    stepObserverContext = context;
+    stepObserverState = withState;
+}
+
+namespace GameManager
+{
+    bool hasStepObserver() { return stepObserver != nullptr; }
+    bool stepObserverWantsState() { return stepObserverState; }
+
+    void reportStep(size_t step, const std::string &state)
+    {
+        if (stepObserver)
+            stepObserver(stepObserverContext, step, stepObserverState ? state.data() : nullptr, stepObserverState ? state.size() : 0);
+    }
+}
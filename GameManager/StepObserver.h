@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Optional per-step observer for differential testing of game manager builds (Benchmark/engine_diff).
+// It is called once the game is set up and after every step, with the number of steps done and, if
+// withState is set, a canonical text dump of the game state. It applies to games run on the calling
+// thread, and is looked up with dlsym, so loaders that do not know it are unaffected.
+using TankGameStepObserver = void (*)(void *context, size_t step, const char *state, size_t length);
+extern "C" void tankgame_set_step_observer(TankGameStepObserver observer, void *context, bool withState);
+
+namespace GameManager
+{
+    // Whether the calling thread has an observer, so engines only build a dump when it is wanted
+    bool hasStepObserver();
+    bool stepObserverWantsState();
+    void reportStep(size_t step, const std::string &state);
+}
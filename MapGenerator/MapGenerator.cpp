@@ -0,0 +1,191 @@
+#include "MapGenerator.h"
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+    size_t toSize(const std::string &key, const std::string &value)
+    {
+        try
+        {
+            size_t used = 0;
+            unsigned long long number = std::stoull(value, &used);
+            if (used == value.size() && value[0] != '-')
+                return static_cast<size_t>(number);
+        }
+        catch (const std::exception &)
+        {
+        }
+        throw std::invalid_argument("Invalid " + key + " value: " + value);
+    }
+
+    double toDensity(const std::string &key, const std::string &value)
+    {
+        try
+        {
+            size_t used = 0;
+            double number = std::stod(value, &used);
+            if (used == value.size() && number >= 0 && number <= 1)
+                return number;
+        }
+        catch (const std::exception &)
+        {
+        }
+        throw std::invalid_argument("Invalid " + key + " value (expected 0..1): " + value);
+    }
+}
+
+MapSpec MapSpec::fromParams(const std::map<std::string, std::string> &params)
+{
+    MapSpec spec;
+    for (const auto &[key, value] : params)
+    {
+        if (key == "name")
+            spec.name = value;
+        else if (key == "rows")
+            spec.rows = toSize(key, value);
+        else if (key == "cols")
+            spec.cols = toSize(key, value);
+        else if (key == "walls")
+            spec.wallDensity = toDensity(key, value);
+        else if (key == "mines")
+            spec.mineDensity = toDensity(key, value);
+        else if (key == "tanks")
+            spec.tanks[0] = spec.tanks[1] = toSize(key, value);
+        else if (key == "tanks1")
+            spec.tanks[0] = toSize(key, value);
+        else if (key == "tanks2")
+            spec.tanks[1] = toSize(key, value);
+        else if (key == "max_steps")
+            spec.maxSteps = toSize(key, value);
+        else if (key == "num_shells")
+            spec.numShells = toSize(key, value);
+        else if (key == "seed")
+            spec.seed = toSize(key, value);
+        else if (key == "symmetry")
+        {
+            if (value == "none")
+                spec.symmetry = MapSymmetry::NONE;
+            else if (value == "mirror_x")
+                spec.symmetry = MapSymmetry::MIRROR_X;
+            else if (value == "mirror_y")
+                spec.symmetry = MapSymmetry::MIRROR_Y;
+            else if (value == "rotate")
+                spec.symmetry = MapSymmetry::ROTATE;
+            else
+                throw std::invalid_argument("Invalid symmetry value (none, mirror_x, mirror_y, rotate): " + value);
+        }
+        else if (key != "output" && key != "count")
+            throw std::invalid_argument("Unsupported argument:" + key);
+    }
+
+    if (spec.rows == 0 || spec.cols == 0)
+        throw std::invalid_argument("rows and cols must be positive");
+    if (spec.wallDensity + spec.mineDensity > 1)
+        throw std::invalid_argument("walls + mines must not exceed 1");
+    if (spec.symmetry != MapSymmetry::NONE && spec.tanks[0] != spec.tanks[1])
+        throw std::invalid_argument("a symmetric map needs the same number of tanks for both players");
+    return spec;
+}
+
+std::string MapSpec::title() const
+{
+    if (!name.empty())
+        return name;
+    return "generated " + std::to_string(rows) + "x" + std::to_string(cols) + " seed " + std::to_string(seed);
+}
+
+MapGenerator::MapGenerator(const MapSpec &spec) : spec(spec) {}
+
+size_t MapGenerator::mirrorOf(size_t cell) const
+{
+    size_t y = cell / spec.cols, x = cell % spec.cols;
+    switch (spec.symmetry)
+    {
+    case MapSymmetry::MIRROR_X:
+        return y * spec.cols + (spec.cols - 1 - x);
+    case MapSymmetry::MIRROR_Y:
+        return (spec.rows - 1 - y) * spec.cols + x;
+    case MapSymmetry::ROTATE:
+        return spec.rows * spec.cols - 1 - cell;
+    case MapSymmetry::NONE:
+        break;
+    }
+    return cell;
+}
+
+void MapGenerator::generate()
+{
+    cells.assign(spec.rows * spec.cols, ' ');
+    placeTerrain();
+    placeTanks();
+}
+
+// Every cell is rolled once and copied to its mirror image, so symmetric maps stay symmetric
+void MapGenerator::placeTerrain()
+{
+    std::mt19937_64 rng(spec.seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    for (size_t cell = 0; cell < cells.size(); ++cell)
+    {
+        size_t mirror = mirrorOf(cell);
+        if (mirror < cell)
+            continue;
+        double roll = coin(rng);
+        char c = roll < spec.wallDensity ? '#' : roll < spec.wallDensity + spec.mineDensity ? '@' : ' ';
+        cells[cell] = cells[mirror] = c;
+    }
+}
+
+// Tanks go on random free cells. With symmetry, player 2's tank is the mirror image of player 1's,
+// so a cell on the mirror axis cannot take a tank.
+void MapGenerator::placeTanks()
+{
+    std::mt19937_64 rng(spec.seed ^ 0x9e3779b97f4a7c15ULL);
+    std::uniform_int_distribution<size_t> pick(0, cells.size() - 1);
+
+    size_t wanted = spec.tanks[0] + spec.tanks[1];
+    size_t placed[2] = {0, 0};
+    size_t attempts = 0;
+    size_t maxAttempts = 64 * (wanted + 1) + cells.size();
+    while ((placed[0] < spec.tanks[0] || placed[1] < spec.tanks[1]) && attempts++ < maxAttempts)
+    {
+        size_t cell = pick(rng);
+        if (cells[cell] != ' ')
+            continue;
+        if (spec.symmetry == MapSymmetry::NONE)
+        {
+            int player = placed[0] < spec.tanks[0] && (placed[0] <= placed[1] || placed[1] == spec.tanks[1]) ? 0 : 1;
+            cells[cell] = static_cast<char>('1' + player);
+            placed[player]++;
+            continue;
+        }
+        size_t mirror = mirrorOf(cell);
+        if (mirror == cell || cells[mirror] != ' ')
+            continue;
+        cells[cell] = '1';
+        cells[mirror] = '2';
+        placed[0]++;
+        placed[1]++;
+    }
+
+    if (placed[0] < spec.tanks[0] || placed[1] < spec.tanks[1])
+    {
+        throw std::runtime_error("Only " + std::to_string(placed[0]) + " + " + std::to_string(placed[1]) + " of the " +
+                                 std::to_string(wanted) + " tanks fit on the free cells; lower the densities or the tank counts");
+    }
+}
+
+void MapGenerator::write(std::ostream &out) const
+{
+    out << spec.title() << "\n";
+    out << "MaxSteps = " << spec.maxSteps << "\n";
+    out << "NumShells = " << spec.numShells << "\n";
+    out << "Rows = " << spec.rows << "\n";
+    out << "Cols = " << spec.cols << "\n";
+    for (size_t y = 0; y < spec.rows; ++y)
+    {
+        out.write(&cells[y * spec.cols], static_cast<std::streamsize>(spec.cols));
+        out.put('\n');
+    }
+}
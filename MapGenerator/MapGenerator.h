@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+// How the two halves of a generated map relate; player 2 gets the mirror image of player 1's tanks
+enum class MapSymmetry
+{
+    NONE,
+    MIRROR_X, // left/right: x -> cols-1-x
+    MIRROR_Y, // top/bottom: y -> rows-1-y
+    ROTATE    // 180 degrees around the center
+};
+
+// Everything that decides a generated map; the same spec always gives the same map
+struct MapSpec
+{
+    std::string name;
+    size_t rows = 20;
+    size_t cols = 20;
+    double wallDensity = 0.1; // per-cell probabilities
+    double mineDensity = 0.02;
+    size_t tanks[2] = {1, 1};
+    size_t maxSteps = 1000;
+    size_t numShells = 20;
+    MapSymmetry symmetry = MapSymmetry::NONE;
+    uint64_t seed = 1;
+
+    // Throws std::invalid_argument for unknown keys or values out of range
+    static MapSpec fromParams(const std::map<std::string, std::string> &params);
+    // First line of the map file: the name, or the size and seed when no name was given
+    std::string title() const;
+};
+
+// Random maps in the game's map file format. The board is kept as one flat character grid, so
+// maps of several thousand cells per side with thousands of tanks are generated in seconds.
+class MapGenerator
+{
+private:
+    MapSpec spec;
+    std::vector<char> cells; // row-major, the characters of the map file
+
+    size_t mirrorOf(size_t cell) const;
+    void placeTerrain();
+    void placeTanks();
+
+public:
+    explicit MapGenerator(const MapSpec &spec);
+
+    // Throws std::runtime_error if the tanks do not fit on the free cells
+    void generate();
+    void write(std::ostream &out) const;
+};
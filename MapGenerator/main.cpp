@@ -0,0 +1,55 @@
+#include "MapGenerator.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// map_generator output=<file> [count=<n>] [rows=..] [cols=..] [walls=..] [mines=..] [tanks=..|tanks1=.. tanks2=..]
+//               [max_steps=..] [num_shells=..] [symmetry=none|mirror_x|mirror_y|rotate] [seed=..] [name=..]
+// With count=n, n maps with seeds seed..seed+n-1 are written as <output stem>_<i><extension>
+int main(int argc, char **argv)
+{
+    try
+    {
+        std::map<std::string, std::string> params;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            size_t eqPos = arg.find('=');
+            if (eqPos == std::string::npos)
+                throw std::invalid_argument("Invalid argument format: " + arg);
+            params[arg.substr(0, eqPos)] = arg.substr(eqPos + 1);
+        }
+        if (!params.count("output"))
+            throw std::invalid_argument("Missing required parameter: output");
+
+        MapSpec spec = MapSpec::fromParams(params);
+        size_t count = params.count("count") ? std::stoul(params.at("count")) : 1;
+        std::filesystem::path output = params.at("output");
+        for (size_t i = 0; i < count; ++i)
+        {
+            MapSpec mapSpec = spec;
+            std::filesystem::path file = output;
+            if (count > 1)
+            {
+                mapSpec.seed = spec.seed + i;
+                file = output.parent_path() / (output.stem().string() + "_" + std::to_string(i) + output.extension().string());
+            }
+
+            MapGenerator generator(mapSpec);
+            generator.generate();
+            std::ofstream out(file, std::ios::binary);
+            if (!out)
+                throw std::runtime_error("Cannot create output file: " + file.string());
+            generator.write(out);
+            if (!out.flush())
+                throw std::runtime_error("Failed to write " + file.string());
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
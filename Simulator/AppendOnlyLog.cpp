@@ -0,0 +1,41 @@
+#include "AppendOnlyLog.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+AppendOnlyLog::AppendOnlyLog(const std::string &path, const std::string &header, bool syncToDisk,
+                             const std::function<bool(std::istream &)> &parse, const std::string &mismatchMessage)
+{
+    namespace fs = std::filesystem;
+
+    bool fresh = !fs::exists(path) || fs::file_size(path) == 0;
+    if (!fresh)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        if (!std::getline(in, line) || line != header)
+        {
+            throw std::runtime_error(mismatchMessage);
+        }
+
+        std::uintmax_t validBytes = static_cast<std::uintmax_t>(in.tellg());
+        while (std::getline(in, line))
+        {
+            if (in.eof())
+                break;
+            std::istringstream record(line);
+            if (!parse(record))
+                break;
+            validBytes = static_cast<std::uintmax_t>(in.tellg());
+        }
+        in.close();
+        fs::resize_file(path, validBytes);
+    }
+
+    writer = std::make_unique<BufferedLineWriter>(path, false, syncToDisk);
+    if (fresh)
+    {
+        writer->write(header);
+    }
+}
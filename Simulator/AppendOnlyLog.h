@@ -0,0 +1,23 @@
+#pragma once
+#include "BufferedLineWriter.h"
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+
+// A file that is only ever appended to: a header line naming its kind, then one record per line. It backs
+// the journal (journal=), the result cache (result_cache=) and the plugin cache (plugin_cache=).
+class AppendOnlyLog
+{
+private:
+    std::unique_ptr<BufferedLineWriter> writer;
+
+public:
+    // Hands every complete record of an existing file to parse, stopping at the first it rejects. That
+    // record, everything after it and a line cut off by a crash are dropped from the file, so the next
+    // append starts on a fresh line. Throws mismatchMessage if the file starts with another header.
+    AppendOnlyLog(const std::string &path, const std::string &header, bool syncToDisk,
+                  const std::function<bool(std::istream &)> &parse, const std::string &mismatchMessage);
+
+    void append(std::string line) { writer->write(std::move(line)); }
+};
@@ -0,0 +1,89 @@
+#include "BufferedLineWriter.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+BufferedLineWriter::BufferedLineWriter(const std::string &path, bool truncate, bool syncToDisk) : syncToDisk(syncToDisk)
+{
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    writer = std::thread(&BufferedLineWriter::writerLoop, this);
+}
+
+BufferedLineWriter::~BufferedLineWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    close(fd);
+}
+
+void BufferedLineWriter::write(std::string line)
+{
+    bool flushNow;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(line));
+        flushNow = pending.size() >= FLUSH_BATCH;
+    }
+    if (flushNow)
+        wake.notify_one();
+}
+
+void BufferedLineWriter::writeAll(const std::string &data)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            std::cerr << "Failed to write output line: " << std::strerror(errno) << "\n";
+            return;
+        }
+        written += static_cast<size_t>(n);
+    }
+}
+
+void BufferedLineWriter::writerLoop()
+{
+    std::vector<std::string> batch;
+    std::string data;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wake.wait_for(lock, std::chrono::milliseconds(200), [this]
+                      { return stopping || pending.size() >= FLUSH_BATCH; });
+        batch.swap(pending);
+        bool done = stopping;
+        lock.unlock();
+
+        if (!batch.empty())
+        {
+            data.clear();
+            for (const auto &line : batch)
+            {
+                data += line;
+                data += '\n';
+            }
+            writeAll(data);
+            if (syncToDisk)
+                fdatasync(fd);
+            batch.clear();
+        }
+
+        lock.lock();
+        if (done && pending.empty())
+            break;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+// Appends text lines to a file from a background thread. Callers only queue the line; the writer thread
+// writes what has arrived every 200ms, or as soon as a full batch is waiting. With syncToDisk every
+// batch is also fdatasync'ed, for files that have to survive a crash of the machine.
+class BufferedLineWriter
+{
+private:
+    int fd = -1;
+    bool syncToDisk = false;
+    std::vector<std::string> pending;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread writer;
+
+    static constexpr size_t FLUSH_BATCH = 256;
+
+    void writerLoop();
+    void writeAll(const std::string &data);
+
+public:
+    // Throws if the file cannot be opened; truncate starts it empty, otherwise lines are appended
+    BufferedLineWriter(const std::string &path, bool truncate, bool syncToDisk);
+    // Writes everything still queued before returning
+    ~BufferedLineWriter();
+
+    BufferedLineWriter(const BufferedLineWriter &) = delete;
+    BufferedLineWriter &operator=(const BufferedLineWriter &) = delete;
+
+    void write(std::string line);
+};
@@ -0,0 +1,25 @@
+#include "CompetitionJournal.h"
+#include <sstream>
+
+static const std::string JOURNAL_HEADER = "competition_journal 1 ";
+
+CompetitionJournal::CompetitionJournal(const std::string &path, const std::string &fingerprint)
+{
+    auto parse = [this](std::istream &entry)
+    {
+        size_t taskId;
+        GameOutcome outcome;
+        if (!(entry >> taskId) || !decodeOutcome(entry, outcome))
+            return false;
+        completed[taskId] = outcome;
+        return true;
+    };
+    log = std::make_unique<AppendOnlyLog>(path, JOURNAL_HEADER + fingerprint, true, parse,
+                                          "Journal " + path + " was written for different maps, algorithms or game manager; "
+                                          "remove it or choose another journal file");
+}
+
+void CompetitionJournal::record(size_t taskId, const GameOutcome &outcome)
+{
+    log->append(std::to_string(taskId) + " " + encodeOutcome(outcome));
+}
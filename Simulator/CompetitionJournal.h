@@ -0,0 +1,25 @@
+#pragma once
+#include "AppendOnlyLog.h"
+#include "ResultsLog.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <cstddef>
+
+// Durable record of the finished games of a competition (journal=). The first line holds a fingerprint
+// of the inputs; every following line is one finished task id with its outcome. A run started again
+// with the same inputs reads the journal back, skips those tasks and continues appending to it.
+// Lines still queued when a run dies are lost, which only means those games are played again.
+class CompetitionJournal
+{
+private:
+    std::map<size_t, GameOutcome> completed;
+    std::unique_ptr<AppendOnlyLog> log;
+
+public:
+    // Throws if the journal exists but was written for other inputs
+    CompetitionJournal(const std::string &path, const std::string &fingerprint);
+
+    const std::map<size_t, GameOutcome> &getCompleted() const { return completed; }
+    void record(size_t taskId, const GameOutcome &outcome);
+};
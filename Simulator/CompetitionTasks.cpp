@@ -0,0 +1,87 @@
+#include "CompetitionTasks.h"
+#include <algorithm>
+#include <numeric>
+
+CompetitionTasks::CompetitionTasks(size_t algorithmCount, std::vector<uint64_t> costs, Pairing pairing,
+                                   size_t shardIndex, size_t shardCount)
+    : algorithmCount(algorithmCount), pairing(pairing), mapCosts(std::move(costs))
+{
+    size_t maps = mapCosts.size();
+    firstId.assign(maps + 1, 0);
+    for (size_t k = 0; k < maps; ++k)
+        firstId[k + 1] = firstId[k] + gamesOnMap(k);
+
+    ids = {firstId[maps] * shardIndex / shardCount, firstId[maps] * (shardIndex + 1) / shardCount};
+    firstGame.assign(maps, 0);
+    for (size_t k = 0; k < maps; ++k)
+        firstGame[k] = std::clamp(ids.begin, firstId[k], firstId[k + 1]) - firstId[k];
+
+    order.resize(maps);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b)
+                     { return mapCosts[a] > mapCosts[b]; });
+
+    firstPosition.assign(maps + 1, 0);
+    for (size_t i = 0; i < maps; ++i)
+        firstPosition[i + 1] = firstPosition[i] + gamesInShard(order[i]);
+}
+
+uint64_t CompetitionTasks::gamesInShard(size_t mapIndex) const
+{
+    uint64_t end = std::clamp(ids.end, firstId[mapIndex], firstId[mapIndex + 1]) - firstId[mapIndex];
+    return end - firstGame[mapIndex];
+}
+
+// With an offset of exactly N/2 the rotation pairs every algorithm with the same partner twice, so only the first half plays
+uint64_t CompetitionTasks::gamesOnMap(size_t mapIndex) const
+{
+    uint64_t n = algorithmCount;
+    if (n < 2)
+        return 0;
+    if (pairing == Pairing::FullRoundRobin)
+        return n * (n - 1);
+
+    uint64_t offset = 1 + mapIndex % (n - 1);
+    return 2 * offset == n ? n / 2 : n;
+}
+
+GameTask CompetitionTasks::taskOnMap(size_t mapIndex, uint64_t game) const
+{
+    uint64_t n = algorithmCount;
+    GameTask task{0, 0, mapIndex, firstId[mapIndex] + game};
+    if (pairing == Pairing::FullRoundRobin)
+    {
+        uint64_t opponent = game % (n - 1);
+        task.player1_idx = static_cast<size_t>(game / (n - 1));
+        task.player2_idx = static_cast<size_t>(opponent < task.player1_idx ? opponent : opponent + 1);
+    }
+    else
+    {
+        uint64_t offset = 1 + mapIndex % (n - 1);
+        task.player1_idx = static_cast<size_t>(game);
+        task.player2_idx = static_cast<size_t>((game + offset) % n);
+    }
+    if (!playerSlots.empty())
+    {
+        task.player1_idx = playerSlots[task.player1_idx];
+        task.player2_idx = playerSlots[task.player2_idx];
+    }
+    return task;
+}
+
+GameTask CompetitionTasks::at(uint64_t position) const
+{
+    size_t i = std::upper_bound(firstPosition.begin(), firstPosition.end(), position) - firstPosition.begin() - 1;
+    return taskOnMap(order[i], firstGame[order[i]] + position - firstPosition[i]);
+}
+
+GameTask CompetitionTasks::byId(uint64_t taskId) const
+{
+    size_t k = std::upper_bound(firstId.begin(), firstId.end(), taskId) - firstId.begin() - 1;
+    return taskOnMap(k, taskId - firstId[k]);
+}
+
+uint64_t CompetitionTasks::mapRangeCost(size_t i) const
+{
+    return std::max<uint64_t>(mapCosts[order[i]], 1) * (firstPosition[i + 1] - firstPosition[i]);
+}
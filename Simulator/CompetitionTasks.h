@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// One competition game; maps and algorithms are referred to by index
+struct GameTask
+{
+    size_t player1_idx;
+    size_t player2_idx;
+    size_t mapIndex;
+    uint64_t taskId; // index in map-major order, the same in every run over the same inputs
+};
+
+// Task positions [begin, end) in scheduling order
+struct TaskRange
+{
+    uint64_t begin = 0;
+    uint64_t end = 0;
+};
+
+// The games of a competition, computed from their index instead of being stored, so memory only
+// grows with the number of maps. Two pairings are supported:
+//  - Rotation: on map k every algorithm i plays (i + 1 + k % (N-1)) % N, each pair once
+//  - FullRoundRobin: every ordered pair plays on every map, so both seatings are covered
+// Task ids count the games map by map in map order. Scheduling positions take the maps by
+// decreasing cost instead, so the longest maps are started first.
+// A shard i of n (shard=) holds only the i-th of n contiguous slices of task ids, so it plays the
+// games of few maps; task ids, pairings and positions are otherwise computed as for the whole.
+class CompetitionTasks
+{
+public:
+    enum class Pairing
+    {
+        Rotation,
+        FullRoundRobin
+    };
+
+private:
+    size_t algorithmCount = 0;
+    Pairing pairing = Pairing::Rotation;
+    std::vector<uint64_t> mapCosts;
+    std::vector<size_t> order;            // map indices in scheduling order
+    std::vector<uint64_t> firstId;        // first task id of every map by map index, plus the total
+    std::vector<uint64_t> firstPosition;  // first position of every map in scheduling order, plus the total
+    TaskRange ids;                        // task ids of the shard
+    std::vector<uint64_t> firstGame;      // first game of the shard on every map, by map index
+    std::vector<size_t> playerSlots;      // algorithm index -> index given in tasks, empty for the identity
+
+    uint64_t gamesOnMap(size_t mapIndex) const;
+    GameTask taskOnMap(size_t mapIndex, uint64_t game) const;
+
+public:
+    CompetitionTasks() = default;
+    // mapCosts holds the estimated cost of one game on each map
+    CompetitionTasks(size_t algorithmCount, std::vector<uint64_t> mapCosts, Pairing pairing,
+                     size_t shardIndex = 0, size_t shardCount = 1);
+
+    // Games of the shard, all games without one
+    uint64_t size() const { return firstPosition.empty() ? 0 : firstPosition.back(); }
+    TaskRange idRange() const { return ids; }
+    uint64_t gamesInShard(size_t mapIndex) const;
+    size_t mapCount() const { return mapCosts.size(); }
+    Pairing getPairing() const { return pairing; }
+
+    GameTask at(uint64_t position) const;
+    GameTask byId(uint64_t taskId) const;
+
+    // Player indices of later tasks are translated through slots, e.g. when only some algorithms are loaded
+    void setPlayerSlots(std::vector<size_t> slots) { playerSlots = std::move(slots); }
+
+    // Positions and total estimated cost of the i-th map in scheduling order
+    TaskRange mapRange(size_t i) const { return {firstPosition[i], firstPosition[i + 1]}; }
+    uint64_t mapRangeCost(size_t i) const;
+};
@@ -0,0 +1,46 @@
+#include "ContentHash.h"
+#include <fstream>
+#include <cstdio>
+
+void ContentHash::add(const void *data, size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        state ^= bytes[i];
+        state *= 1099511628211ULL;
+    }
+}
+
+void ContentHash::addString(const std::string &value)
+{
+    uint64_t length = value.size();
+    add(&length, sizeof(length));
+    add(value.data(), value.size());
+}
+
+bool ContentHash::addFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+
+    char chunk[1 << 16];
+    uint64_t size = 0;
+    while (in)
+    {
+        in.read(chunk, sizeof(chunk));
+        std::streamsize n = in.gcount();
+        add(chunk, static_cast<size_t>(n));
+        size += static_cast<uint64_t>(n);
+    }
+    add(&size, sizeof(size));
+    return true;
+}
+
+std::string ContentHash::hex() const
+{
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(state));
+    return text;
+}
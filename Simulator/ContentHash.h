@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Incremental 64-bit FNV-1a hash, used to fingerprint the files a competition is run on
+class ContentHash
+{
+private:
+    uint64_t state = 14695981039346656037ULL;
+
+public:
+    void add(const void *data, size_t size);
+    // Length-prefixed, so consecutive strings cannot run into each other
+    void addString(const std::string &value);
+    // Adds the file size and contents; false if the file cannot be read
+    bool addFile(const std::string &path);
+
+    uint64_t value() const { return state; }
+    std::string hex() const;
+};
@@ -0,0 +1,683 @@
+#include "Daemon.h"
+#include "AlgorithmRegistrar.h"
+#include "GameManagerRegistrar.h"
+#include "UserCommon/SatelliteViewImpl.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace UserCommon;
+
+static volatile std::sig_atomic_t daemonStopRequested = 0;
+
+static void requestDaemonStop(int)
+{
+    daemonStopRequested = 1;
+}
+
+DaemonPlugin::~DaemonPlugin()
+{
+    playerFactory = nullptr;
+    tankAlgorithmFactory = nullptr;
+    gameManagerFactory = nullptr;
+    if (handle)
+        dlclose(handle);
+}
+
+// Plugins are opened from private copies, so a submission overwritten in place never changes code
+// that is running, and every version gets a path of its own for dlopen
+Daemon::Daemon(Simulator &simulator, const std::string &socketPath, size_t poolSize)
+    : simulator(simulator), socketPath(socketPath), poolSize(poolSize),
+      copies(fs::temp_directory_path() / ("tankgame_daemon_" + std::to_string(getpid())))
+{
+    fs::create_directories(copies);
+}
+
+Daemon::~Daemon()
+{
+    shutdown();
+    if (listenFd >= 0)
+    {
+        ::close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    for (int fd : wake)
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+    std::error_code ec;
+    fs::remove_all(copies, ec);
+}
+
+void Daemon::run()
+{
+    if (pipe(wake) != 0)
+        throw std::runtime_error(std::string("pipe failed: ") + std::strerror(errno));
+    fcntl(wake[0], F_SETFL, O_NONBLOCK);
+    fcntl(wake[1], F_SETFL, O_NONBLOCK);
+
+    listenFd = LineSocket::listenOnUnix(socketPath);
+
+    simulator.openMemoryGate(simulator.memoryState, poolSize);
+    for (size_t i = 0; i < poolSize; ++i)
+    {
+        pool.emplace_back(&Daemon::poolLoop, this);
+    }
+
+    struct sigaction stop{};
+    stop.sa_handler = requestDaemonStop;
+    sigemptyset(&stop.sa_mask);
+    sigaction(SIGINT, &stop, nullptr);
+    sigaction(SIGTERM, &stop, nullptr);
+    std::cout << "Daemon listening on " << socketPath << " with " << poolSize << " threads" << std::endl;
+
+    lastCheck = std::chrono::steady_clock::now();
+    while (!daemonStopRequested && serveOnce())
+    {
+    }
+
+    shutdown();
+    std::cout << "Daemon stopped" << std::endl;
+}
+
+// Waits up to a second for a new client, a finished game or a job line, and handles what arrived
+bool Daemon::serveOnce()
+{
+    std::vector<pollfd> fds;
+    fds.push_back({listenFd, POLLIN, 0});
+    fds.push_back({wake[0], POLLIN, 0});
+    std::vector<uint64_t> polled;
+    for (const auto &[id, job] : jobs)
+    {
+        if (!job->socket.isOpen())
+            continue;
+        fds.push_back({job->socket.getFd(), POLLIN, 0});
+        polled.push_back(id);
+    }
+    if (poll(fds.data(), fds.size(), 1000) < 0)
+    {
+        if (errno == EINTR)
+            return true;
+        std::cerr << "poll failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    if (std::chrono::steady_clock::now() - lastCheck >= std::chrono::seconds(1))
+    {
+        checkPlugins();
+        lastCheck = std::chrono::steady_clock::now();
+    }
+
+    if (fds[1].revents & POLLIN)
+    {
+        char drain[256];
+        while (read(wake[0], drain, sizeof(drain)) > 0)
+        {
+        }
+        deliverCompletions();
+    }
+
+    for (size_t i = 0; i < polled.size(); ++i)
+    {
+        if (fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR))
+            dispatch(polled[i]);
+    }
+
+    if (fds[0].revents & POLLIN)
+        acceptClient();
+    return true;
+}
+
+// Stops the pool, after the games it is playing, and tells the clients still waiting
+void Daemon::shutdown()
+{
+    queue.close();
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+    pool.clear();
+    for (auto &[id, job] : jobs)
+    {
+        if (job->socket.isOpen())
+            job->socket.sendLine("ERROR The daemon was stopped");
+    }
+    jobs.clear();
+    completed.clear();
+    plugins.clear();
+}
+
+std::shared_ptr<DaemonPlugin> Daemon::loadVersion(const std::string &file, PluginFile &plugin)
+{
+    auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    auto &gmRegistrar = GameManagerRegistrar::getGameManagerRegistrar();
+
+    unsigned version = ++plugin.versions;
+    fs::path copy = copies / (std::to_string(version) + "_" + fs::path(file).filename().string());
+    std::shared_ptr<DaemonPlugin> loaded;
+    size_t before = plugin.type == SharedObjectType::Algorithm ? registrar.count() : gmRegistrar.count();
+    try
+    {
+        fs::copy_file(file, copy, fs::copy_options::overwrite_existing);
+        simulator.loadSharedObjectFromFile(file, plugin.type, copy.string());
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Skipping file " << fs::path(file) << " due to error: " << e.what() << std::endl;
+        fs::remove(copy);
+        return loaded;
+    }
+    fs::remove(copy);
+
+    // The daemon owns the handle and the factories; the registrars only served for registering
+    void *handle = simulator.soHandles.back();
+    simulator.soHandles.pop_back();
+    size_t after = plugin.type == SharedObjectType::Algorithm ? registrar.count() : gmRegistrar.count();
+    if (after == before)
+    {
+        dlclose(handle);
+        return loaded;
+    }
+    loaded = std::make_shared<DaemonPlugin>();
+    loaded->version = version;
+    loaded->handle = handle;
+    if (plugin.type == SharedObjectType::Algorithm)
+    {
+        auto &entry = registrar.getAlgorithm(before);
+        loaded->name = entry.name();
+        loaded->playerFactory = entry.getPlayerFactory();
+        loaded->tankAlgorithmFactory = entry.getTankAlgorithmFactory();
+        registrar.removeLast();
+    }
+    else
+    {
+        auto &entry = gmRegistrar.getGM()[before];
+        loaded->name = entry.name;
+        loaded->gameManagerFactory = entry.getFactory();
+        gmRegistrar.removeLast();
+    }
+    return loaded;
+}
+
+// The current version of a plugin file, loaded on first use and again when it changed
+std::shared_ptr<const DaemonPlugin> Daemon::loadPlugin(const std::string &path, SharedObjectType type)
+{
+    std::string file = fs::weakly_canonical(path).string();
+    if (!fs::is_regular_file(file))
+        throw std::runtime_error("File does not exist or is not a regular file: " + path);
+    auto mtime = fs::last_write_time(file);
+    auto size = fs::file_size(file);
+    auto [entry, added] = plugins.try_emplace(file, PluginFile{type, mtime, size, nullptr, 0, false, mtime, size});
+    if (added || entry->second.mtime != mtime || entry->second.size != size)
+        reloadPlugin(file, entry->second, mtime, size);
+    return entry->second.current;
+}
+
+void Daemon::reloadPlugin(const std::string &file, PluginFile &plugin, fs::file_time_type mtime, std::uintmax_t size)
+{
+    plugin.mtime = mtime;
+    plugin.size = size;
+    plugin.changed = false;
+    auto old = plugin.current;
+    plugin.current = loadVersion(file, plugin);
+    if (old && plugin.current)
+    {
+        std::cout << "Reloaded " << file << " as version " << plugin.current->version << std::endl;
+        replacePlugin(old, plugin.current);
+    }
+    else if (old)
+    {
+        std::cerr << "New version of " << file << " does not load; running jobs keep version " << old->version << std::endl;
+    }
+}
+
+// Switches the running jobs from one version of a plugin to the next and plays their affected games again
+void Daemon::replacePlugin(const std::shared_ptr<const DaemonPlugin> &old, const std::shared_ptr<const DaemonPlugin> &fresh)
+{
+    for (auto &[id, job] : jobs)
+    {
+        if (!job->games)
+            continue;
+        auto games = std::make_shared<DaemonGames>(*job->games);
+        bool uses = false;
+        for (auto *list : {&games->algorithms, &games->gameManagers})
+        {
+            for (auto &plugin : *list)
+            {
+                if (plugin == old)
+                {
+                    plugin = fresh;
+                    uses = true;
+                }
+            }
+        }
+        if (!uses)
+            continue;
+
+        std::vector<uint64_t> again;
+        for (uint64_t game = 0; game < job->outcomes.size(); ++game)
+        {
+            auto used = pluginsOf(*games, game);
+            if (job->outcomes[game].winner >= 0 && std::find(used.begin(), used.end(), fresh.get()) != used.end())
+            {
+                job->outcomes[game] = GameOutcome();
+                again.push_back(game);
+            }
+        }
+        job->unfinished += again.size();
+        job->games = games;
+        queue.reschedule(id, games, again);
+        if (job->socket.isOpen())
+            job->socket.sendLine("RELOAD " + fresh->name + " version " + std::to_string(fresh->version) + ", " +
+                                 std::to_string(again.size()) + " finished games are played again");
+    }
+}
+
+// A plugin that changed is reloaded once it looked the same at two checks in a row, so a file that is
+// still being written is not loaded half way
+void Daemon::checkPlugins()
+{
+    for (auto &[file, plugin] : plugins)
+    {
+        std::error_code ec;
+        auto mtime = fs::last_write_time(file, ec);
+        std::uintmax_t size = ec ? 0 : fs::file_size(file, ec);
+        if (ec || (mtime == plugin.mtime && size == plugin.size))
+        {
+            plugin.changed = false;
+            continue;
+        }
+        if (plugin.changed && mtime == plugin.seenMtime && size == plugin.seenSize)
+        {
+            reloadPlugin(file, plugin, mtime, size);
+            continue;
+        }
+        plugin.changed = true;
+        plugin.seenMtime = mtime;
+        plugin.seenSize = size;
+    }
+}
+
+std::shared_ptr<GameBoard> Daemon::loadMap(const std::string &path)
+{
+    std::error_code ec;
+    auto mtime = fs::last_write_time(path, ec);
+    if (ec)
+        return std::shared_ptr<GameBoard>();
+    auto cached = boards.find(path);
+    if (cached == boards.end() || cached->second.mtime != mtime)
+    {
+        std::shared_ptr<GameBoard> board;
+        try
+        {
+            board = simulator.createGameBoard(path);
+        }
+        catch (const std::exception &)
+        {
+            std::cout << "Skipping invalid map: " << path << "\n";
+        }
+        cached = boards.insert_or_assign(path, CachedBoard{mtime, board}).first;
+    }
+    return cached->second.board;
+}
+
+std::array<const DaemonPlugin *, 3> Daemon::pluginsOf(const DaemonGames &games, uint64_t game)
+{
+    if (games.comparative)
+        return std::array<const DaemonPlugin *, 3>{games.algorithms[0].get(), games.algorithms[1].get(), games.gameManagers[game].get()};
+    GameTask task = games.tasks.byId(game);
+    return std::array<const DaemonPlugin *, 3>{games.algorithms[task.player1_idx].get(), games.algorithms[task.player2_idx].get(), games.gameManagers[0].get()};
+}
+
+void Daemon::acceptClient()
+{
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd >= 0)
+    {
+        jobs[nextJobId] = std::make_unique<Job>();
+        jobs[nextJobId++]->socket = LineSocket(fd);
+    }
+}
+
+// Reads from a client; its first line is the job, anything after that is ignored
+void Daemon::dispatch(uint64_t id)
+{
+    auto it = jobs.find(id);
+    if (it == jobs.end())
+        return;
+    Job &job = *it->second;
+    if (!job.socket.receive())
+    {
+        dropClient(id);
+        return;
+    }
+    std::string line;
+    if (job.games || !job.socket.nextLine(line))
+        return;
+    try
+    {
+        startJob(id, job, line);
+        if (job.unfinished == 0)
+        {
+            finishJob(id, job);
+            jobs.erase(it);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Job " << id << " rejected: " << e.what() << "\n";
+        job.socket.sendLine(std::string("ERROR ") + e.what());
+        jobs.erase(it);
+    }
+}
+
+void Daemon::startJob(uint64_t id, Job &job, const std::string &line)
+{
+    std::istringstream in(line);
+    std::string field;
+    std::getline(in, field, '\t');
+    if (field != "JOB competition" && field != "JOB comparative")
+        throw std::invalid_argument("Unexpected message: " + line);
+    while (std::getline(in, field, '\t'))
+    {
+        size_t eqPos = field.find('=');
+        if (eqPos == std::string::npos)
+            throw std::invalid_argument("Invalid argument format: " + field);
+        job.request[field.substr(0, eqPos)] = field.substr(eqPos + 1);
+    }
+
+    fs::path cwd = job.request.count("cwd") ? fs::path(job.request.at("cwd")) : fs::current_path();
+    auto resolve = [&](const std::string &key)
+    {
+        if (!job.request.count(key))
+            throw std::invalid_argument("Missing required parameter: " + key);
+        return (cwd / job.request.at(key)).string();
+    };
+
+    auto games = std::make_shared<DaemonGames>();
+    games->comparative = line.rfind("JOB comparative", 0) == 0;
+    games->verbose = job.request.count("verbose") > 0;
+
+    uint64_t count = 0;
+    if (games->comparative)
+    {
+        for (const std::string key : {"algorithm1", "algorithm2"})
+        {
+            auto plugin = loadPlugin(resolve(key), SharedObjectType::Algorithm);
+            if (!plugin)
+                throw std::runtime_error("Failed to load algorithm: " + job.request.at(key));
+            games->algorithms.push_back(plugin);
+        }
+        job.outputFolder = resolve("game_managers_folder");
+        for (const auto &file : sortedDirectoryFiles(job.outputFolder, ".so"))
+        {
+            if (auto plugin = loadPlugin(file, SharedObjectType::GameManager))
+                games->gameManagers.push_back(plugin);
+        }
+        if (games->gameManagers.empty())
+            throw std::runtime_error("Directory '" + job.request.at("game_managers_folder") + "' does not contain any valid .so files.");
+
+        games->mapFiles.push_back(resolve("game_map"));
+        games->boards.push_back(loadMap(games->mapFiles[0]));
+        games->mapMemory.push_back(simulator.estimateTaskMemory(games->mapFiles[0]));
+        if (!games->boards[0])
+            throw std::runtime_error("Failed to load or invalid board file: " + job.request.at("game_map"));
+        count = games->gameManagers.size();
+        job.finalStates.resize(count);
+    }
+    else
+    {
+        job.outputFolder = resolve("algorithms_folder");
+        for (const auto &file : sortedDirectoryFiles(job.outputFolder, ".so"))
+        {
+            if (auto plugin = loadPlugin(file, SharedObjectType::Algorithm))
+                games->algorithms.push_back(plugin);
+        }
+        if (games->algorithms.size() < 2)
+            throw std::runtime_error("At least two algorithms are required for competition mode.");
+        auto gm = loadPlugin(resolve("game_manager"), SharedObjectType::GameManager);
+        if (!gm)
+            throw std::runtime_error("Failed to load game manager: " + job.request.at("game_manager"));
+        games->gameManagers.push_back(gm);
+
+        std::vector<uint64_t> costs;
+        for (const auto &map : sortedDirectoryFiles(resolve("game_maps_folder"), ""))
+        {
+            games->mapFiles.push_back(map);
+            games->boards.push_back(loadMap(map));
+            games->mapMemory.push_back(simulator.estimateTaskMemory(map));
+            costs.push_back(simulator.estimateTaskCost(map));
+        }
+        std::string pairing = job.request.count("round_robin") ? job.request.at("round_robin") : "rotation";
+        if (pairing != "full" && pairing != "rotation")
+            throw std::invalid_argument("round_robin must be full or rotation");
+        games->tasks = CompetitionTasks(games->algorithms.size(), std::move(costs),
+                                        pairing == "full" ? CompetitionTasks::Pairing::FullRoundRobin : CompetitionTasks::Pairing::Rotation);
+        count = games->tasks.size();
+    }
+
+    job.games = games;
+    job.unfinished = count;
+    job.outcomes.assign(count, GameOutcome());
+    job.start = std::chrono::steady_clock::now();
+    queue.add(id, count, games);
+    std::cout << "Job " << id << ": " << (games->comparative ? "comparison" : "competition") << " of " << count << " games" << std::endl;
+}
+
+// Hands the games the pool finished to their jobs and clients
+void Daemon::deliverCompletions()
+{
+    std::vector<Completion> batch;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        batch.swap(completed);
+    }
+    for (auto &completion : batch)
+    {
+        auto it = jobs.find(completion.job);
+        if (it == jobs.end())
+            continue;
+        Job &job = *it->second;
+        const DaemonGames &games = *job.games;
+        const GameOutcome &outcome = completion.outcome;
+
+        // Played with a plugin that has been replaced while the game ran: play it again
+        if (pluginsOf(*completion.games, completion.game) != pluginsOf(games, completion.game))
+        {
+            queue.reschedule(it->first, job.games, {completion.game});
+            continue;
+        }
+        job.unfinished--;
+        job.outcomes[completion.game] = outcome;
+
+        std::string json;
+        if (games.comparative)
+        {
+            json = ResultsLog::jsonLine(fs::path(games.mapFiles[0]).stem().string(), games.algorithms[0]->name, games.algorithms[1]->name,
+                                        outcome, games.gameManagers[completion.game]->name);
+            job.finalStates[completion.game] = std::move(completion.finalState);
+        }
+        else
+        {
+            GameTask task = games.tasks.byId(completion.game);
+            json = ResultsLog::jsonLine(fs::path(games.mapFiles[task.mapIndex]).stem().string(),
+                                        games.algorithms[task.player1_idx]->name, games.algorithms[task.player2_idx]->name, outcome);
+        }
+
+        if (job.socket.isOpen() && !job.socket.sendLine("GAME " + json))
+        {
+            dropClient(it->first);
+            continue;
+        }
+        if (job.unfinished == 0)
+        {
+            if (job.socket.isOpen())
+                finishJob(it->first, job);
+            jobs.erase(it);
+        }
+    }
+}
+
+// Writes the result file the same run without daemon= would have written
+void Daemon::finishJob(uint64_t id, Job &job)
+{
+    const DaemonGames &games = *job.games;
+    std::string stem = job.outputFolder + (games.comparative ? "/comparative_results_" : "/competition_") + simulator.getTimeString();
+    std::string outputFile = stem + ".txt";
+    if (fs::exists(outputFile))
+        outputFile = stem + "_" + std::to_string(id) + ".txt";
+    std::ofstream out(outputFile);
+    if (!out)
+    {
+        job.socket.sendLine("ERROR Cannot create output file: " + outputFile);
+        return;
+    }
+
+    if (games.comparative)
+    {
+        std::map<std::string, ComparativeResult> groupedResults;
+        for (size_t i = 0; i < job.outcomes.size(); ++i)
+        {
+            const GameOutcome &outcome = job.outcomes[i];
+            if (outcome.winner < 0)
+                continue;
+            std::ostringstream sig;
+            sig << outcome.winner << "|" << outcome.reason << "|" << outcome.rounds << "|" << job.finalStates[i];
+            auto &group = groupedResults[sig.str()];
+            group.result.winner = outcome.winner;
+            group.result.reason = static_cast<GameResult::Reason>(outcome.reason);
+            group.result.rounds = outcome.rounds;
+            group.gmNames.push_back(games.gameManagers[i]->name);
+            group.finalState = job.finalStates[i];
+        }
+        writeComparativeResults(out, job.request.at("game_map"), job.request.at("algorithm1"), job.request.at("algorithm2"), groupedResults);
+    }
+    else
+    {
+        std::vector<AlgorithmStats> stats(games.algorithms.size());
+        for (uint64_t game = 0; game < job.outcomes.size(); ++game)
+        {
+            if (job.outcomes[game].winner >= 0)
+                Simulator::addGameResult(stats, games.tasks.byId(game), job.outcomes[game].winner, job.outcomes[game].rounds);
+        }
+
+        std::map<std::string, int> scores;
+        for (size_t i = 0; i < games.algorithms.size(); ++i)
+        {
+            scores[games.algorithms[i]->name] += stats[i].score;
+        }
+        writeCompetitionResults(out, job.request.at("game_maps_folder"), job.request.at("game_manager"), "", scores);
+    }
+    out.close();
+
+    job.socket.sendLine("DONE " + outputFile);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - job.start).count();
+    std::cout << "Job " << id << " finished in " << std::fixed << std::setprecision(2) << seconds << std::defaultfloat
+              << "s, results in " << outputFile << std::endl;
+}
+
+// A client that goes away takes its queued games with it; games already running finish unreported
+void Daemon::dropClient(uint64_t id)
+{
+    auto &job = *jobs.at(id);
+    job.socket.close();
+    if (job.games)
+    {
+        uint64_t dropped = queue.cancel(id);
+        job.unfinished -= dropped;
+        if (dropped > 0)
+            std::cout << "Job " << id << ": client disconnected, " << dropped << " games dropped" << std::endl;
+    }
+    if (!job.games || job.unfinished == 0)
+        jobs.erase(id);
+}
+
+void Daemon::poolLoop()
+{
+    uint64_t id, game;
+    std::shared_ptr<const DaemonGames> games;
+    MemoryGate::Holder memory;
+    while (queue.pop(id, game, games))
+    {
+        Completion completion = playThroughGate(id, game, games, memory);
+        games.reset();
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.push_back(std::move(completion));
+        }
+        queue.done(id);
+        char signal = 1;
+        ssize_t written = write(wake[1], &signal, 1);
+        (void)written; // a full pipe already wakes the main thread
+    }
+}
+
+// A game starts once the memory gate admits its map, so the pool stays within memory_budget_mb
+Daemon::Completion Daemon::playThroughGate(uint64_t id, uint64_t game, const std::shared_ptr<const DaemonGames> &games, MemoryGate::Holder &memory)
+{
+    Completion completion{id, game, games, GameOutcome(), ""};
+    size_t mapIndex = games->comparative ? 0 : games->tasks.byId(game).mapIndex;
+    MemoryGate::Admission admission(*simulator.memoryGate, memory, games->mapMemory[mapIndex]);
+    completion.outcome = playGame(*games, game, completion.finalState);
+    return completion;
+}
+
+// One game of a job, played only from what the job captured. finalState receives the final board of a
+// comparison, which is what its game managers are grouped by.
+GameOutcome Daemon::playGame(const DaemonGames &games, uint64_t game, std::string &finalState)
+{
+    size_t gmIndex = 0;
+    GameTask task{0, 1, 0, game};
+    if (games.comparative)
+        gmIndex = static_cast<size_t>(game);
+    else
+        task = games.tasks.byId(game);
+
+    const auto &gameBoard = games.boards[task.mapIndex];
+    if (!gameBoard)
+    {
+        return GameOutcome();
+    }
+
+    try
+    {
+        const DaemonPlugin &algorithm1 = *games.algorithms[task.player1_idx];
+        const DaemonPlugin &algorithm2 = *games.algorithms[task.player2_idx];
+        auto p1 = algorithm1.playerFactory(1, gameBoard->getWidth(), gameBoard->getHeight(), gameBoard->getMaxSteps(), 0);
+        auto p2 = algorithm2.playerFactory(2, gameBoard->getWidth(), gameBoard->getHeight(), gameBoard->getMaxSteps(), 0);
+        auto gm = games.gameManagers[gmIndex]->gameManagerFactory(games.verbose);
+        auto sat = SatelliteViewImpl(*gameBoard, Position(-1, -1));
+        auto mapName = fs::path(games.mapFiles[task.mapIndex]).stem().string();
+
+        auto start = std::chrono::steady_clock::now();
+        GameResult result = gm->run(
+            gameBoard->getWidth(), gameBoard->getHeight(),
+            dynamic_cast<SatelliteView &>(sat), mapName,
+            gameBoard->getMaxSteps(), gameBoard->getNumShells(),
+            *p1, algorithm1.name,
+            *p2, algorithm2.name,
+            algorithm1.tankAlgorithmFactory,
+            algorithm2.tankAlgorithmFactory);
+        if (games.comparative)
+            finalState = gameStateToString(result, gameBoard->getWidth(), gameBoard->getHeight());
+        return Simulator::makeOutcome(result, start);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error in daemon game " << game << ": " << e.what() << std::endl;
+        return GameOutcome();
+    }
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include "Simulator.h"
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// One version of a plugin loaded by the daemon. The jobs whose games use it share it, and it is unloaded
+// once the last of them lets go after the daemon replaced it with a newer version of the file.
+struct DaemonPlugin
+{
+    std::string name;
+    unsigned version = 1;
+    void *handle = nullptr;
+    PlayerFactory playerFactory;
+    TankAlgorithmFactory tankAlgorithmFactory;
+    GameManagerRegistrar::GameManagerFactory gameManagerFactory;
+
+    DaemonPlugin() = default;
+    DaemonPlugin(const DaemonPlugin &) = delete;
+    DaemonPlugin &operator=(const DaemonPlugin &) = delete;
+    // Drops the factories before closing the handle, as their code lives in the plugin
+    ~DaemonPlugin();
+};
+
+// Everything the daemon's pool threads need to play the games of one job, captured when the job is
+// accepted and replaced as a whole when one of its plugins is reloaded, so games never touch the
+// registrars or see a plugin change under them
+struct DaemonGames
+{
+    bool comparative = false;
+    bool verbose = false;
+    std::vector<std::shared_ptr<const DaemonPlugin>> algorithms;
+    std::vector<std::shared_ptr<const DaemonPlugin>> gameManagers;
+    std::vector<std::string> mapFiles;
+    std::vector<std::shared_ptr<UserCommon::GameBoard>> boards; // by map index, null for an invalid map; only read
+    std::vector<uint64_t> mapMemory; // estimated bytes of one game, by map index
+    CompetitionTasks tasks; // a competition plays game i as tasks.byId(i), a comparison with game manager i
+};
+
+// Keeps plugins, boards and a pool of threads loaded across runs and plays the jobs that runs with
+// daemon=<socket> hand over. One job per connection, as text lines:
+//   run    -> daemon: JOB competition|comparative, then tab separated key=value parameters; relative
+//                     paths are taken from cwd=
+//   daemon -> run:    GAME <json> for every finished game, in the results_log format,
+//                     RELOAD <message> when a plugin of the job was replaced and its games are played again,
+//                     then DONE <result file> once the usual result file is written, or ERROR <message>
+// Pool threads take the games of all jobs from one FairShareQueue. Everything else, accepting jobs,
+// loading plugins and writing results, happens on the thread that calls run.
+//
+// Every loaded plugin file is checked once a second. A plugin that changed, and has stayed the same
+// for a second since, is loaded again as a new version next to the old one. Running jobs switch to the
+// new version: their games that used the old one are played again, and games still running on it are
+// played again when they report. The old version is unloaded when its last game is done.
+class Daemon
+{
+public:
+    // Plugins are loaded and maps read through simulator, which also holds the memory gate of the pool
+    Daemon(Simulator &simulator, const std::string &socketPath, size_t poolSize);
+    ~Daemon();
+
+    Daemon(const Daemon &) = delete;
+    Daemon &operator=(const Daemon &) = delete;
+
+    // Serves jobs until SIGINT or SIGTERM
+    void run();
+
+private:
+    struct PluginFile
+    {
+        SharedObjectType type;
+        std::filesystem::file_time_type mtime; // of the loaded version
+        std::uintmax_t size = 0;
+        std::shared_ptr<const DaemonPlugin> current; // null while the file does not register
+        unsigned versions = 0;
+        bool changed = false; // seen different from the loaded version at the last check
+        std::filesystem::file_time_type seenMtime;
+        std::uintmax_t seenSize = 0;
+    };
+
+    // Boards are loaded again only when the map file changed
+    struct CachedBoard
+    {
+        std::filesystem::file_time_type mtime;
+        std::shared_ptr<UserCommon::GameBoard> board;
+    };
+
+    struct Job
+    {
+        LineSocket socket;
+        std::map<std::string, std::string> request;
+        std::shared_ptr<const DaemonGames> games;
+        uint64_t unfinished = 0;
+        std::string outputFolder;
+        std::vector<GameOutcome> outcomes;    // by game, winner -1 until played
+        std::vector<std::string> finalStates; // comparison, by game manager
+        std::chrono::steady_clock::time_point start;
+    };
+
+    struct Completion
+    {
+        uint64_t job;
+        uint64_t game;
+        std::shared_ptr<const DaemonGames> games; // as the game was played
+        GameOutcome outcome;
+        std::string finalState;
+    };
+
+    Simulator &simulator;
+    std::string socketPath;
+    size_t poolSize;
+    std::filesystem::path copies; // private copies of the loaded plugins
+
+    std::map<std::string, PluginFile> plugins; // by canonical path
+    std::chrono::steady_clock::time_point lastCheck;
+    std::map<std::string, CachedBoard> boards;
+    std::map<uint64_t, std::unique_ptr<Job>> jobs;
+    uint64_t nextJobId = 1;
+    FairShareQueue<DaemonGames> queue;
+
+    std::mutex completedMutex;
+    std::vector<Completion> completed;
+    int wake[2] = {-1, -1}; // pool threads wake the main thread through this pipe
+    int listenFd = -1;
+    std::vector<std::thread> pool;
+
+    // Plugins and maps
+    std::shared_ptr<DaemonPlugin> loadVersion(const std::string &file, PluginFile &plugin);
+    std::shared_ptr<const DaemonPlugin> loadPlugin(const std::string &path, SharedObjectType type);
+    void reloadPlugin(const std::string &file, PluginFile &plugin, std::filesystem::file_time_type mtime, std::uintmax_t size);
+    void replacePlugin(const std::shared_ptr<const DaemonPlugin> &old, const std::shared_ptr<const DaemonPlugin> &fresh);
+    void checkPlugins();
+    std::shared_ptr<UserCommon::GameBoard> loadMap(const std::string &path);
+    // The algorithms and game manager a game is played with
+    static std::array<const DaemonPlugin *, 3> pluginsOf(const DaemonGames &games, uint64_t game);
+
+    // Main thread
+    bool serveOnce();
+    void acceptClient();
+    void dispatch(uint64_t id);
+    void startJob(uint64_t id, Job &job, const std::string &line);
+    void deliverCompletions();
+    void finishJob(uint64_t id, Job &job);
+    void dropClient(uint64_t id);
+    void shutdown();
+
+    // Pool threads
+    void poolLoop();
+    Completion playThroughGate(uint64_t id, uint64_t game, const std::shared_ptr<const DaemonGames> &games, MemoryGate::Holder &memory);
+    static GameOutcome playGame(const DaemonGames &games, uint64_t game, std::string &finalState);
+};
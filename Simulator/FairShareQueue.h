@@ -0,0 +1,149 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Games of concurrently running jobs, shared by one pool of threads. A job is a run of numbered
+// games [0, count) together with the context they are played from. A free thread takes the next game
+// of the job with the fewest games running, the oldest job on a tie, so every job gets an equal share
+// of the pool and a short job is never queued behind a long one. Single games of a job can be queued
+// again, ahead of its remaining ones, e.g. after a plugin they used was replaced.
+template <typename Context>
+class FairShareQueue
+{
+private:
+    struct Job
+    {
+        uint64_t id = 0;
+        std::shared_ptr<const Context> context;
+        uint64_t next = 0;
+        uint64_t count = 0;
+        size_t running = 0;
+        std::deque<uint64_t> again; // games queued once more, taken before next
+    };
+
+    std::mutex mutex;
+    std::condition_variable available;
+    std::vector<Job> jobs; // in arrival order
+    bool closed = false;
+
+    Job *find(uint64_t id)
+    {
+        for (auto &job : jobs)
+        {
+            if (job.id == id)
+                return &job;
+        }
+        return nullptr;
+    }
+
+    void removeFinished()
+    {
+        std::erase_if(jobs, [](const Job &job)
+                      { return job.next == job.count && job.again.empty() && job.running == 0; });
+    }
+
+public:
+    void add(uint64_t id, uint64_t count, std::shared_ptr<const Context> context)
+    {
+        if (count == 0)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back({id, std::move(context), 0, count, 0, {}});
+        }
+        available.notify_all();
+    }
+
+    // Blocks until a game is available; false once the queue is closed
+    bool pop(uint64_t &id, uint64_t &game, std::shared_ptr<const Context> &context)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            if (closed)
+                return false;
+            Job *chosen = nullptr;
+            for (auto &job : jobs)
+            {
+                if ((job.next < job.count || !job.again.empty()) && (!chosen || job.running < chosen->running))
+                    chosen = &job;
+            }
+            if (chosen)
+            {
+                id = chosen->id;
+                if (!chosen->again.empty())
+                {
+                    game = chosen->again.front();
+                    chosen->again.pop_front();
+                }
+                else
+                {
+                    game = chosen->next++;
+                }
+                context = chosen->context;
+                chosen->running++;
+                return true;
+            }
+            available.wait(lock);
+        }
+    }
+
+    // A game taken with pop has been played
+    void done(uint64_t id)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (Job *job = find(id))
+        {
+            job->running--;
+            removeFinished();
+        }
+    }
+
+    // Drops the games of the job that no thread has taken yet and returns how many there were
+    uint64_t cancel(uint64_t id)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Job *job = find(id);
+        if (!job)
+            return 0;
+        uint64_t dropped = job->count - job->next + job->again.size();
+        job->count = job->next;
+        job->again.clear();
+        removeFinished();
+        return dropped;
+    }
+
+    // Games taken from now on are played from context, and the given games are queued once more
+    void reschedule(uint64_t id, std::shared_ptr<const Context> context, const std::vector<uint64_t> &games)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Job *job = find(id);
+            if (!job)
+            {
+                if (games.empty())
+                    return;
+                jobs.push_back({id, nullptr, 0, 0, 0, {}});
+                job = &jobs.back();
+            }
+            job->context = std::move(context);
+            job->again.insert(job->again.end(), games.begin(), games.end());
+        }
+        available.notify_all();
+    }
+
+    // Every waiting thread wakes up and pop returns false from now on; games in progress are finished
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        available.notify_all();
+    }
+};
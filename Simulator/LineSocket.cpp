@@ -0,0 +1,203 @@
+#include "LineSocket.h"
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+LineSocket::~LineSocket()
+{
+    close();
+}
+
+LineSocket::LineSocket(LineSocket &&other) noexcept : fd(other.fd), buffer(std::move(other.buffer))
+{
+    other.fd = -1;
+}
+
+LineSocket &LineSocket::operator=(LineSocket &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        fd = other.fd;
+        buffer = std::move(other.buffer);
+        other.fd = -1;
+    }
+    return *this;
+}
+
+void LineSocket::close()
+{
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+}
+
+bool LineSocket::sendLine(const std::string &line)
+{
+    std::string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool LineSocket::receive()
+{
+    char chunk[4096];
+    ssize_t n;
+    do
+    {
+        n = recv(fd, chunk, sizeof(chunk), 0);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0)
+        return false;
+    buffer.append(chunk, static_cast<size_t>(n));
+    return true;
+}
+
+bool LineSocket::nextLine(std::string &line)
+{
+    size_t end = buffer.find('\n');
+    if (end == std::string::npos)
+        return false;
+    line = buffer.substr(0, end);
+    buffer.erase(0, end + 1);
+    return true;
+}
+
+bool LineSocket::readLine(std::string &line)
+{
+    while (!nextLine(line))
+    {
+        if (!receive())
+            return false;
+    }
+    return true;
+}
+
+int LineSocket::listenOn(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        throw std::runtime_error(std::string("Failed to create socket: ") + std::strerror(errno));
+
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, 64) != 0)
+    {
+        std::string err = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Failed to listen on port " + std::to_string(port) + ": " + err);
+    }
+    return fd;
+}
+
+LineSocket LineSocket::connectTo(const std::string &host, const std::string &port)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    int rc = getaddrinfo(host.c_str(), port.c_str(), &hints, &result);
+    if (rc != 0)
+        throw std::runtime_error("Cannot resolve " + host + ": " + gai_strerror(rc));
+
+    int fd = -1;
+    for (addrinfo *ai = result; ai; ai = ai->ai_next)
+    {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0)
+            continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+            break;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    if (fd < 0)
+        throw std::runtime_error("Cannot connect to " + host + ":" + port);
+
+    // Results are small lines; send them right away and notice dead peers
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &yes, sizeof(yes));
+    return LineSocket(fd);
+}
+
+// Fills a Unix domain socket address; false if the path does not fit
+static bool unixAddress(const std::string &path, sockaddr_un &addr)
+{
+    addr = sockaddr_un{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        return false;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+int LineSocket::listenOnUnix(const std::string &path)
+{
+    sockaddr_un addr;
+    if (!unixAddress(path, addr))
+        throw std::runtime_error("Invalid socket path: " + path);
+
+    // A socket file left behind by a daemon that was killed would make bind fail; one that still
+    // accepts connections belongs to a running daemon and is left alone
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0 && connect(probe, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0)
+    {
+        ::close(probe);
+        throw std::runtime_error("Another daemon is already listening on " + path);
+    }
+    if (probe >= 0)
+        ::close(probe);
+    unlink(path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        throw std::runtime_error(std::string("Failed to create socket: ") + std::strerror(errno));
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, 64) != 0)
+    {
+        std::string err = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Failed to listen on " + path + ": " + err);
+    }
+    return fd;
+}
+
+LineSocket LineSocket::connectToUnix(const std::string &path)
+{
+    sockaddr_un addr;
+    if (!unixAddress(path, addr))
+        throw std::runtime_error("Invalid socket path: " + path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        throw std::runtime_error(std::string("Failed to create socket: ") + std::strerror(errno));
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+    {
+        std::string err = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Cannot connect to daemon at " + path + ": " + err);
+    }
+    return LineSocket(fd);
+}
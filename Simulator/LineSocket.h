@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+// Blocking stream connection exchanging newline-terminated text lines: TCP between a coordinator and its
+// workers, a Unix domain socket between the daemon and the runs that submit jobs to it
+class LineSocket
+{
+private:
+    int fd = -1;
+    std::string buffer;
+
+public:
+    LineSocket() = default;
+    explicit LineSocket(int fd) : fd(fd) {}
+    ~LineSocket();
+
+    LineSocket(LineSocket &&other) noexcept;
+    LineSocket &operator=(LineSocket &&other) noexcept;
+    LineSocket(const LineSocket &) = delete;
+    LineSocket &operator=(const LineSocket &) = delete;
+
+    int getFd() const { return fd; }
+    bool isOpen() const { return fd >= 0; }
+    void close();
+
+    bool sendLine(const std::string &line);
+    // Read whatever is available into the buffer; false once the peer closed or the connection failed
+    bool receive();
+    // Take the next complete line out of the buffer, if there is one
+    bool nextLine(std::string &line);
+    // Wait for the next line; false if the connection ends first
+    bool readLine(std::string &line);
+
+    // Listening socket on all interfaces, throws on failure
+    static int listenOn(uint16_t port);
+    // Throws if host:port cannot be reached
+    static LineSocket connectTo(const std::string &host, const std::string &port);
+    // Listening Unix domain socket at path, replacing a stale socket file; throws on failure
+    static int listenOnUnix(const std::string &path);
+    // Throws if nothing listens at path
+    static LineSocket connectToUnix(const std::string &path);
+};
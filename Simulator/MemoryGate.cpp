@@ -0,0 +1,88 @@
+#include "MemoryGate.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+// The state may live in memory shared between processes, which is only sound without lock fallbacks
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the memory gate needs lock-free 64-bit atomics");
+
+void MemoryGate::acquire(Holder &holder, uint64_t bytes)
+{
+    if (budget == 0)
+        return;
+
+    // Clamped, so a game above the budget still fits once nothing else runs
+    bytes = std::min(bytes, budget);
+    bool reserving = false;
+    while (true)
+    {
+        uint64_t used = state.inUse.load();
+        uint64_t reserved = reserving ? 0 : state.reserved.load();
+        if (used + reserved + bytes <= budget)
+        {
+            if (!state.inUse.compare_exchange_weak(used, used + bytes))
+                continue;
+            holder.bytes.store(bytes);
+            if (reserving)
+            {
+                state.reserved.store(0);
+                holder.reserving.store(0);
+            }
+            return;
+        }
+
+        // Only one game reserves at a time; the others wait behind it
+        uint64_t none = 0;
+        if (!reserving && state.reserved.compare_exchange_strong(none, bytes))
+        {
+            reserving = true;
+            holder.reserving.store(bytes);
+            continue;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+void MemoryGate::release(Holder &holder)
+{
+    uint64_t bytes = holder.bytes.exchange(0);
+    if (bytes > 0)
+        state.inUse.fetch_sub(bytes);
+    uint64_t reserving = holder.reserving.exchange(0);
+    if (reserving > 0)
+        state.reserved.compare_exchange_strong(reserving, 0);
+}
+
+uint64_t MemoryGate::availableBytes()
+{
+    std::ifstream in("/proc/meminfo");
+    std::string line;
+    unsigned long long kb = 0;
+    while (std::getline(in, line))
+    {
+        if (sscanf(line.c_str(), "MemAvailable: %llu kB", &kb) == 1)
+            return static_cast<uint64_t>(kb) << 10;
+    }
+    return 0;
+}
+
+uint64_t MemoryGate::processStatusKb(const std::string &field)
+{
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.compare(0, field.size(), field) == 0 && line.size() > field.size() && line[field.size()] == ':')
+            return std::strtoull(line.c_str() + field.size() + 1, nullptr, 10);
+    }
+    return 0;
+}
+
+bool MemoryGate::resetPeakRss()
+{
+    std::ofstream out("/proc/self/clear_refs");
+    return static_cast<bool>(out << "5" << std::flush);
+}
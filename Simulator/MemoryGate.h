@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Admission control for concurrent games by their estimated memory (memory_budget_mb=). A game starts
+// when its estimate fits in the budget next to the games already running. The first game that does
+// not fit reserves its share, and later games only start while they leave that share free, so small
+// games keep the other workers busy without starving a big one. A game larger than the whole budget
+// runs alone. The state is plain lock-free atomics, so the same gate works between threads and,
+// placed in shared memory, between worker processes.
+class MemoryGate
+{
+public:
+    struct State
+    {
+        alignas(64) std::atomic<uint64_t> inUse{0};
+        std::atomic<uint64_t> reserved{0};
+    };
+
+    // What one worker holds, so the share of a worker process that died can be given back
+    struct Holder
+    {
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> reserving{0};
+    };
+
+    // Holds an admission for the lifetime of a game
+    class Admission
+    {
+    private:
+        MemoryGate &gate;
+        Holder &holder;
+
+    public:
+        Admission(MemoryGate &gate, Holder &holder, uint64_t bytes) : gate(gate), holder(holder) { gate.acquire(holder, bytes); }
+        ~Admission() { gate.release(holder); }
+
+        Admission(const Admission &) = delete;
+        Admission &operator=(const Admission &) = delete;
+    };
+
+private:
+    State &state;
+    uint64_t budget; // 0 admits everything
+
+public:
+    MemoryGate(State &state, uint64_t budgetBytes) : state(state), budget(budgetBytes) {}
+
+    uint64_t budgetBytes() const { return budget; }
+
+    // Waits until the bytes may be used; a holder has at most one admission at a time
+    void acquire(Holder &holder, uint64_t bytes);
+    // Gives back whatever the holder has, including a reservation it was still waiting on
+    void release(Holder &holder);
+
+    // MemAvailable of /proc/meminfo, 0 if unknown
+    static uint64_t availableBytes();
+    // A kB field of /proc/self/status, e.g. VmRSS or VmHWM; 0 if unknown
+    static uint64_t processStatusKb(const std::string &field);
+    // Sets VmHWM back to the current RSS, so the next read is the peak from now on
+    static bool resetPeakRss();
+};
@@ -0,0 +1,181 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+MetricsRegistry::MetricsRegistry(size_t shardCount) : shards(new Shard[std::max<size_t>(shardCount, 1)]), shardCount(std::max<size_t>(shardCount, 1)) {}
+
+static int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void MetricsRegistry::gameStarted(size_t shard)
+{
+    shards[shard % shardCount].gameStartNs.store(steadyNowNs(), std::memory_order_relaxed);
+}
+
+void MetricsRegistry::recordGame(size_t shard, double durationMs)
+{
+    Shard &s = shards[shard % shardCount];
+    s.gameStartNs.store(0, std::memory_order_relaxed);
+    s.games.fetch_add(1, std::memory_order_relaxed);
+    s.busyNs.fetch_add(static_cast<uint64_t>(durationMs * 1e6), std::memory_order_relaxed);
+
+    size_t bucket = 0;
+    while (bucket < LATENCY_BUCKETS && durationMs > bucketBoundMs(bucket))
+        ++bucket;
+    s.latency[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::recordFailure(size_t shard)
+{
+    shards[shard % shardCount].gameStartNs.store(0, std::memory_order_relaxed);
+    shards[shard % shardCount].failed.fetch_add(1, std::memory_order_relaxed);
+}
+
+MetricsRegistry::Snapshot MetricsRegistry::snapshot() const
+{
+    Snapshot total;
+    int64_t now = steadyNowNs();
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        const Shard &s = shards[i];
+        total.games += s.games.load(std::memory_order_relaxed);
+        total.failed += s.failed.load(std::memory_order_relaxed);
+        uint64_t busy = s.busyNs.load(std::memory_order_relaxed);
+        total.busyNs += busy;
+        int64_t started = s.gameStartNs.load(std::memory_order_relaxed);
+        total.busyNsByShard.push_back(busy + (started > 0 && now > started ? now - started : 0));
+        for (size_t b = 0; b <= LATENCY_BUCKETS; ++b)
+            total.latency[b] += s.latency[b].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+MetricsReporter::MetricsReporter(const MetricsRegistry &registry, uint64_t totalGames, double intervalSec, bool toStderr,
+                                 const std::string &metricsFile, std::function<uint64_t()> queueDepth, bool busyIsTotal)
+    : registry(registry), totalGames(totalGames),
+      interval(std::max<long long>(1, static_cast<long long>(intervalSec * 1000))),
+      toStderr(toStderr), metricsFile(metricsFile), queueDepth(std::move(queueDepth)), busyIsTotal(busyIsTotal),
+      start(std::chrono::steady_clock::now()), lastTime(start), last(registry.snapshot())
+{
+    reporter = std::thread(&MetricsReporter::reporterLoop, this);
+}
+
+MetricsReporter::~MetricsReporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    reporter.join();
+    publish();
+}
+
+void MetricsReporter::reporterLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, interval, [this]
+                          { return stopping; }))
+    {
+        lock.unlock();
+        publish();
+        lock.lock();
+    }
+}
+
+void MetricsReporter::publish()
+{
+    auto now = std::chrono::steady_clock::now();
+    MetricsRegistry::Snapshot current = registry.snapshot();
+    double elapsed = std::chrono::duration<double>(now - start).count();
+    double window = std::chrono::duration<double>(now - lastTime).count();
+
+    uint64_t finished = current.games + current.failed;
+    double rate = elapsed > 0 ? current.games / elapsed : 0;
+    double eta = rate > 0 && totalGames > finished ? (totalGames - finished) / rate : 0;
+    uint64_t depth = queueDepth ? queueDepth() : 0;
+
+    std::vector<double> utilization;
+    for (size_t i = 0; i < current.busyNsByShard.size(); ++i)
+    {
+        double busy = std::max(0.0, (double(current.busyNsByShard[i]) - double(last.busyNsByShard[i])) / 1e9);
+        utilization.push_back(window > 0 ? busy / window : 0);
+    }
+    last = current;
+    lastTime = now;
+
+    if (toStderr)
+    {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1) << "[progress] " << finished << "/" << totalGames << " games ("
+             << (totalGames ? 100.0 * finished / totalGames : 100.0) << "%), " << rate << " games/s, ETA "
+             << static_cast<long long>(eta) / 60 << "m" << std::setw(2) << std::setfill('0') << static_cast<long long>(eta) % 60 << "s"
+             << std::setfill(' ') << ", queue " << depth;
+        if (current.failed)
+            line << ", " << current.failed << " failed";
+        if (busyIsTotal)
+            line << ", busy workers " << (utilization.empty() ? 0 : utilization[0]);
+        else
+        {
+            line << ", workers";
+            for (double u : utilization)
+                line << " " << std::setprecision(0) << std::min(100.0, u * 100) << "%";
+        }
+        std::cerr << line.str() << std::endl;
+    }
+
+    if (metricsFile.empty())
+        return;
+
+    std::ostringstream out;
+    auto metric = [&out](const char *name, const char *type, const char *help)
+    {
+        out << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+    };
+    metric("tankgame_games_completed_total", "counter", "Games finished and scored in this run");
+    out << "tankgame_games_completed_total " << current.games << "\n";
+    metric("tankgame_games_failed_total", "counter", "Games that could not be played");
+    out << "tankgame_games_failed_total " << current.failed << "\n";
+    metric("tankgame_games_planned", "gauge", "Games this run has to play");
+    out << "tankgame_games_planned " << totalGames << "\n";
+    metric("tankgame_queue_depth", "gauge", "Games not handed to a worker yet");
+    out << "tankgame_queue_depth " << depth << "\n";
+    metric("tankgame_games_per_second", "gauge", "Games finished per second since the start of the run");
+    out << "tankgame_games_per_second " << rate << "\n";
+    metric("tankgame_eta_seconds", "gauge", "Estimated seconds until all games are finished");
+    out << "tankgame_eta_seconds " << eta << "\n";
+    metric("tankgame_worker_utilization", "gauge", "Share of the last interval a worker spent in games");
+    for (size_t i = 0; i < utilization.size(); ++i)
+        out << "tankgame_worker_utilization{worker=\"" << i << "\"} " << utilization[i] << "\n";
+    metric("tankgame_game_duration_seconds", "histogram", "Wall-clock time of a game");
+    uint64_t cumulative = 0;
+    for (size_t b = 0; b < MetricsRegistry::LATENCY_BUCKETS; ++b)
+    {
+        cumulative += current.latency[b];
+        out << "tankgame_game_duration_seconds_bucket{le=\"" << MetricsRegistry::bucketBoundMs(b) / 1000 << "\"} " << cumulative << "\n";
+    }
+    out << "tankgame_game_duration_seconds_bucket{le=\"+Inf\"} " << current.games << "\n";
+    out << "tankgame_game_duration_seconds_sum " << current.busyNs / 1e9 << "\n";
+    out << "tankgame_game_duration_seconds_count " << current.games << "\n";
+
+    // A scraper must never see half a file
+    std::string temp = metricsFile + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        file << out.str();
+        if (!file)
+        {
+            std::cerr << "Cannot write metrics file: " << temp << "\n";
+            return;
+        }
+    }
+    if (std::rename(temp.c_str(), metricsFile.c_str()) != 0)
+        std::cerr << "Cannot replace metrics file: " << metricsFile << "\n";
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// Game counters and latency histograms of a competition, one shard per worker. A worker only ever
+// writes its own shard, on its own cache line, with relaxed atomics; readers sum the shards.
+class MetricsRegistry
+{
+public:
+    // Game duration buckets with upper bounds of 1ms, 2ms, 4ms, ... ~16 minutes, plus +Inf
+    static constexpr size_t LATENCY_BUCKETS = 20;
+
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> games{0};
+        std::atomic<uint64_t> failed{0};
+        std::atomic<uint64_t> busyNs{0};
+        std::atomic<int64_t> gameStartNs{0}; // steady clock, 0 while idle or when starts are not reported
+        std::atomic<uint64_t> latency[LATENCY_BUCKETS + 1] = {};
+    };
+
+    // Sums over all shards at one point in time
+    struct Snapshot
+    {
+        uint64_t games = 0;
+        uint64_t failed = 0;
+        uint64_t busyNs = 0;
+        uint64_t latency[LATENCY_BUCKETS + 1] = {};
+        std::vector<uint64_t> busyNsByShard; // including the running part of games in progress
+    };
+
+private:
+    std::unique_ptr<Shard[]> shards;
+    size_t shardCount;
+
+public:
+    explicit MetricsRegistry(size_t shardCount);
+
+    size_t size() const { return shardCount; }
+
+    // Optional; without it the time of a game counts as busy only once the game is recorded
+    void gameStarted(size_t shard);
+    void recordGame(size_t shard, double durationMs);
+    void recordFailure(size_t shard);
+
+    Snapshot snapshot() const;
+    static double bucketBoundMs(size_t bucket) { return static_cast<double>(uint64_t(1) << bucket); }
+};
+
+// Publishes the registry every interval from a background thread: one progress line on stderr
+// (progress=) and/or a Prometheus text file (metrics_file=) that is replaced atomically.
+// The last report is written when the reporter is destroyed.
+class MetricsReporter
+{
+private:
+    const MetricsRegistry &registry;
+    uint64_t totalGames;
+    std::chrono::milliseconds interval;
+    bool toStderr;
+    std::string metricsFile;
+    std::function<uint64_t()> queueDepth;
+    bool busyIsTotal; // one shard for many remote workers: report how many were busy, not a fraction
+
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point lastTime;
+    MetricsRegistry::Snapshot last;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread reporter;
+
+    void reporterLoop();
+    void publish();
+
+public:
+    MetricsReporter(const MetricsRegistry &registry, uint64_t totalGames, double intervalSec, bool toStderr,
+                    const std::string &metricsFile, std::function<uint64_t()> queueDepth, bool busyIsTotal = false);
+    ~MetricsReporter();
+
+    MetricsReporter(const MetricsReporter &) = delete;
+    MetricsReporter &operator=(const MetricsReporter &) = delete;
+};
@@ -0,0 +1,80 @@
+#include "PluginCache.h"
+#include "ContentHash.h"
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+static const std::string CACHE_HEADER = "plugin_cache 1";
+
+PluginCache::PluginCache(const std::string &path)
+{
+    auto parse = [this](std::istream &fields)
+    {
+        Entry entry;
+        int status = 0;
+        std::string file;
+        if (!(fields >> entry.size >> entry.mtime >> std::hex >> entry.hash >> std::dec >> status) || !std::getline(fields >> std::ws, file))
+            return false;
+        entry.status = static_cast<Status>(status);
+        entries[file] = entry;
+        return true;
+    };
+    log = std::make_unique<AppendOnlyLog>(path, CACHE_HEADER, false, parse, path + " is not a plugin cache file");
+}
+
+bool PluginCache::fileStamp(const std::string &path, uint64_t &size, int64_t &mtime)
+{
+    std::error_code ec;
+    size = fs::file_size(path, ec);
+    if (ec)
+        return false;
+    auto written = fs::last_write_time(path, ec);
+    if (ec)
+        return false;
+    mtime = static_cast<int64_t>(written.time_since_epoch().count());
+    return true;
+}
+
+const PluginCache::Entry *PluginCache::lookup(const std::string &path) const
+{
+    auto it = entries.find(fs::absolute(path).lexically_normal().string());
+    uint64_t size;
+    int64_t mtime;
+    if (it == entries.end() || !fileStamp(path, size, mtime) || it->second.size != size || it->second.mtime != mtime)
+        return nullptr;
+    return &it->second;
+}
+
+uint64_t PluginCache::hashOf(const std::string &path)
+{
+    if (const Entry *known = lookup(path))
+        return known->hash;
+
+    ContentHash hash;
+    if (!hash.addFile(path))
+        throw std::runtime_error("Cannot read " + path);
+    return hash.value();
+}
+
+void PluginCache::record(const std::string &path, Status status)
+{
+    Entry entry;
+    if (!fileStamp(path, entry.size, entry.mtime))
+        return;
+    entry.hash = hashOf(path);
+    entry.status = status;
+
+    std::string file = fs::absolute(path).lexically_normal().string();
+    const Entry *known = lookup(path);
+    if (known && known->hash == entry.hash && known->status == status)
+        return;
+    entries[file] = entry;
+
+    std::ostringstream line;
+    line << entry.size << " " << entry.mtime << " " << std::hex << std::setw(16) << std::setfill('0') << entry.hash
+         << std::dec << " " << static_cast<int>(status) << " " << file;
+    log->append(line.str());
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "AppendOnlyLog.h"
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+// What is known about plugin files from earlier runs (plugin_cache=). Each .so is recorded with its
+// size, modification time and content hash, and whether it registered correctly. While size and
+// mtime still match, the hash is trusted without reading the file again and the registration
+// outcome is known. Like the result cache, lines are only appended; a later line for the same path
+// replaces an earlier one.
+class PluginCache
+{
+public:
+    enum class Status : int
+    {
+        VALID, // loaded and registered all its factories
+        BAD    // failed to load or registered incompletely
+    };
+
+    struct Entry
+    {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t hash = 0;
+        Status status = Status::VALID;
+    };
+
+private:
+    std::unordered_map<std::string, Entry> entries; // by absolute path
+    std::unique_ptr<AppendOnlyLog> log;
+
+    static bool fileStamp(const std::string &path, uint64_t &size, int64_t &mtime);
+
+public:
+    explicit PluginCache(const std::string &path);
+
+    // The entry of the file if it has not changed since it was recorded, otherwise nullptr
+    const Entry *lookup(const std::string &path) const;
+    // Content hash of the file, as ContentHash::addFile computes it; read again only if the file changed
+    uint64_t hashOf(const std::string &path);
+    void record(const std::string &path, Status status);
+};
@@ -0,0 +1,49 @@
+#include "ResultCache.h"
+#include <sstream>
+#include <iomanip>
+#include <random>
+
+static const std::string CACHE_HEADER = "result_cache 1";
+
+ResultCache::ResultCache(const std::string &path, double verifyPercent)
+    : verifyPerMille(static_cast<unsigned>(verifyPercent * 10)), sampleSeed(std::random_device()())
+{
+    auto parse = [this](std::istream &entry)
+    {
+        uint64_t key;
+        GameOutcome outcome;
+        if (!(entry >> std::hex >> key >> std::dec) || !decodeOutcome(entry, outcome))
+            return false;
+        entries[key] = outcome;
+        return true;
+    };
+    log = std::make_unique<AppendOnlyLog>(path, CACHE_HEADER, false, parse, path + " is not a result cache file");
+}
+
+bool ResultCache::find(uint64_t key, GameOutcome &out) const
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return false;
+    out = it->second;
+    return true;
+}
+
+bool ResultCache::sampledForVerification(uint64_t key) const
+{
+    if (verifyPerMille == 0)
+        return false;
+    // splitmix64 finalizer; the keys are already hashes, this only decorrelates them from the seed
+    uint64_t x = key ^ sampleSeed;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x % 1000 < verifyPerMille;
+}
+
+void ResultCache::store(uint64_t key, const GameOutcome &outcome)
+{
+    std::ostringstream line;
+    line << std::hex << std::setw(16) << std::setfill('0') << key << std::dec << " " << encodeOutcome(outcome);
+    log->append(line.str());
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "AppendOnlyLog.h"
+#include "ResultsLog.h"
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+// Outcomes of earlier games kept across runs (result_cache=). A game is keyed by the hashes of the
+// game manager, both algorithm binaries in seating order and the map contents, so a changed file
+// simply misses. Every line of the file is one key with its outcome; a later line replaces an
+// earlier one with the same key. New outcomes are appended, the file is never rewritten.
+class ResultCache
+{
+private:
+    std::unordered_map<uint64_t, GameOutcome> entries;
+    std::unique_ptr<AppendOnlyLog> log;
+    unsigned verifyPerMille = 0;
+    uint64_t sampleSeed = 0;
+
+public:
+    // verifyPercent of the hits are played again and compared with the cached outcome
+    ResultCache(const std::string &path, double verifyPercent);
+
+    bool find(uint64_t key, GameOutcome &out) const;
+    // Decided per key and run, so every process of a run agrees and another run picks other games
+    bool sampledForVerification(uint64_t key) const;
+    void store(uint64_t key, const GameOutcome &outcome);
+};
@@ -0,0 +1,88 @@
+#include "ResultsLog.h"
+#include "common/SatelliteView.h"
+#include "common/GameResult.h"
+#include <memory>
+#include <sstream>
+#include <iomanip>
+
+namespace
+{
+    const char *reasonName(int reason)
+    {
+        switch (reason)
+        {
+        case GameResult::Reason::ALL_TANKS_DEAD:
+            return "ALL_TANKS_DEAD";
+        case GameResult::Reason::MAX_STEPS:
+            return "MAX_STEPS";
+        case GameResult::Reason::ZERO_SHELLS:
+            return "ZERO_SHELLS";
+        }
+        return "UNKNOWN";
+    }
+
+    std::string jsonString(const std::string &value)
+    {
+        std::string escaped = "\"";
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                std::ostringstream code;
+                code << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c);
+                escaped += code.str();
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+        return escaped + "\"";
+    }
+}
+
+std::string encodeOutcome(const GameOutcome &outcome)
+{
+    std::ostringstream out;
+    out << outcome.winner << " " << outcome.reason << " " << outcome.rounds << " "
+        << outcome.remainingTanks[0] << " " << outcome.remainingTanks[1] << " "
+        << std::fixed << std::setprecision(3) << outcome.durationMs;
+    return out.str();
+}
+
+bool decodeOutcome(std::istream &in, GameOutcome &outcome)
+{
+    return static_cast<bool>(in >> outcome.winner >> outcome.reason >> outcome.rounds
+                                >> outcome.remainingTanks[0] >> outcome.remainingTanks[1] >> outcome.durationMs);
+}
+
+std::string ResultsLog::jsonLine(const std::string &mapName, const std::string &player1, const std::string &player2, const GameOutcome &outcome,
+                                 const std::string &gameManager)
+{
+    std::ostringstream line;
+    line << "{\"map\": " << jsonString(mapName);
+    if (!gameManager.empty())
+        line << ", \"game_manager\": " << jsonString(gameManager);
+    line << ", \"player1\": " << jsonString(player1)
+         << ", \"player2\": " << jsonString(player2)
+         << ", \"winner\": " << outcome.winner
+         << ", \"reason\": \"" << reasonName(outcome.reason) << "\""
+         << ", \"rounds\": " << outcome.rounds
+         << ", \"remaining_tanks\": [" << outcome.remainingTanks[0] << ", " << outcome.remainingTanks[1] << "]"
+         << ", \"time_ms\": " << std::fixed << std::setprecision(3) << outcome.durationMs
+         << ", \"cached\": " << (outcome.cacheUse == CacheUse::HIT ? "true" : "false");
+    if (outcome.peakRssKb > 0)
+        line << ", \"peak_rss_kb\": " << outcome.peakRssKb;
+    line << "}";
+    return line.str();
+}
+
+void ResultsLog::record(const std::string &mapName, const std::string &player1, const std::string &player2, const GameOutcome &outcome)
+{
+    writer.write(jsonLine(mapName, player1, player2, outcome));
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "BufferedLineWriter.h"
+#include <istream>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// How the result cache (result_cache=) was involved in a game
+enum class CacheUse : int
+{
+    NONE,     // played, nothing cached
+    HIT,      // taken from the cache, not played
+    VERIFIED, // played again and equal to the cached outcome
+    MISMATCH  // played again and different from the cached outcome
+};
+
+// What is kept of a finished competition game. Fixed size, so it can also travel through shared memory.
+struct GameOutcome
+{
+    int winner = -1; // 0 = tie, -1 = the game could not be played
+    int reason = 0;  // GameResult::Reason
+    size_t rounds = 0;
+    size_t remainingTanks[2] = {0, 0};
+    double durationMs = 0;
+    CacheUse cacheUse = CacheUse::NONE;
+    uint64_t peakRssKb = 0; // peak RSS of the process during the game, only measured where it plays one game at a time
+};
+
+// The text form of an outcome in the journal, the result cache and worker messages:
+// "winner reason rounds tanks1 tanks2 durationMs". Cache use and peak RSS are not part of it.
+std::string encodeOutcome(const GameOutcome &outcome);
+bool decodeOutcome(std::istream &in, GameOutcome &outcome);
+
+// Appends one JSON line per finished game to a file (results_log=), which every run starts empty; a run
+// resumed from a journal logs the journaled games first. Games are handed over from any thread and
+// written out in batches, so game threads never wait on the disk.
+class ResultsLog
+{
+private:
+    BufferedLineWriter writer;
+
+public:
+    explicit ResultsLog(const std::string &path) : writer(path, true, false) {}
+
+    void record(const std::string &mapName, const std::string &player1, const std::string &player2, const GameOutcome &outcome);
+
+    // The JSON line of one game; the game manager is only named when given, as for comparative games
+    static std::string jsonLine(const std::string &mapName, const std::string &player1, const std::string &player2, const GameOutcome &outcome,
+                                const std::string &gameManager = "");
+};
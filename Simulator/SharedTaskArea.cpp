@@ -0,0 +1,67 @@
+#include "SharedTaskArea.h"
+#include <sys/mman.h>
+#include <sched.h>
+#include <new>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+// The atomics are shared between processes, which is only sound when they do not fall back to locks
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<int64_t>::is_always_lock_free,
+              "multi-process mode needs lock-free 64-bit atomics");
+
+SharedTaskArea::SharedTaskArea(size_t workerCount) : workers(workerCount)
+{
+    bytes = sizeof(Header) + workers * sizeof(WorkerChannel);
+    memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        memory = nullptr;
+        throw std::runtime_error(std::string("Failed to map shared task area: ") + std::strerror(errno));
+    }
+
+    header = new (memory) Header();
+    channels = reinterpret_cast<WorkerChannel *>(static_cast<char *>(memory) + sizeof(Header));
+    for (size_t i = 0; i < workers; ++i)
+        new (&channels[i]) WorkerChannel();
+}
+
+SharedTaskArea::~SharedTaskArea()
+{
+    if (memory)
+        munmap(memory, bytes);
+}
+
+int64_t SharedTaskArea::claimTask(uint64_t totalTasks)
+{
+    uint64_t index = header->nextTask.fetch_add(1, std::memory_order_relaxed);
+    return index < totalTasks ? static_cast<int64_t>(index) : -1;
+}
+
+bool SharedTaskArea::allClaimed(uint64_t totalTasks) const
+{
+    return header->nextTask.load(std::memory_order_relaxed) >= totalTasks;
+}
+
+void SharedTaskArea::push(size_t worker, const ProcessGameResult &result)
+{
+    auto &ring = channels[worker];
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    while (tail - ring.head.load(std::memory_order_acquire) >= RING_CAPACITY)
+        sched_yield();
+
+    ring.slots[tail % RING_CAPACITY] = result;
+    ring.tail.store(tail + 1, std::memory_order_release);
+}
+
+bool SharedTaskArea::pop(size_t worker, ProcessGameResult &out)
+{
+    auto &ring = channels[worker];
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head == ring.tail.load(std::memory_order_acquire))
+        return false;
+
+    out = ring.slots[head % RING_CAPACITY];
+    ring.head.store(head + 1, std::memory_order_release);
+    return true;
+}
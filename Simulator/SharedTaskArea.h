@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "ResultsLog.h"
+#include "MemoryGate.h"
+
+// Result of one game, written by a worker process into its ring
+struct ProcessGameResult
+{
+    uint64_t position; // of the game in scheduling order
+    GameOutcome outcome;
+};
+
+// Shared memory of the multi-process competition mode. It is mapped before forking, so the parent and
+// every worker see the same pages. Workers claim task indices from a single counter and push results
+// into their own single-producer ring, which only the parent reads. A worker that dies can therefore
+// only strand its own ring, and the parent drains it before starting a replacement.
+class SharedTaskArea
+{
+public:
+    static constexpr size_t RING_CAPACITY = 256;
+
+    struct WorkerChannel
+    {
+        alignas(64) std::atomic<uint64_t> head{0}; // next slot the parent reads
+        alignas(64) std::atomic<uint64_t> tail{0}; // next slot the worker writes
+        std::atomic<int64_t> currentTask{-1};      // task being played, -1 when idle
+        MemoryGate::Holder memory;                 // given back by the parent if the worker dies
+        ProcessGameResult slots[RING_CAPACITY];
+    };
+
+private:
+    struct Header
+    {
+        alignas(64) std::atomic<uint64_t> nextTask{0};
+        MemoryGate::State memory;
+    };
+
+    void *memory = nullptr;
+    size_t bytes = 0;
+    size_t workers = 0;
+    Header *header = nullptr;
+    WorkerChannel *channels = nullptr;
+
+public:
+    explicit SharedTaskArea(size_t workerCount);
+    ~SharedTaskArea();
+
+    SharedTaskArea(const SharedTaskArea &) = delete;
+    SharedTaskArea &operator=(const SharedTaskArea &) = delete;
+
+    size_t workerCount() const { return workers; }
+
+    // Next task index to play, -1 once all of the totalTasks have been handed out
+    int64_t claimTask(uint64_t totalTasks);
+    bool allClaimed(uint64_t totalTasks) const;
+    uint64_t claimedCount() const { return header->nextTask.load(std::memory_order_relaxed); }
+
+    WorkerChannel &channel(size_t worker) { return channels[worker]; }
+    // Shared by all workers, so memory_budget_mb= holds for the whole competition
+    MemoryGate::State &memoryState() { return header->memory; }
+
+    // Worker side; waits while the ring is full
+    void push(size_t worker, const ProcessGameResult &result);
+    // Parent side; false when the worker's ring is empty
+    bool pop(size_t worker, ProcessGameResult &out);
+};
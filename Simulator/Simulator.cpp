@@ -1,4 +1,5 @@
 #include "Simulator.h"
+#include "Daemon.h"
 #include "AlgorithmRegistrar.h"
 #include "common/GameManagerRegistration.h"
 #include "GameManagerRegistrar.h"
@@ -16,10 +17,24 @@
 #include <algorithm>
 #include <cmath>
 #include <unordered_set>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <deque>
+#include <array>
 
 using namespace std;
 namespace fs = std::filesystem;
-using namespace UserCommon_318885712_208230862;
+using namespace UserCommon;
 
 // Constructor
 Simulator::Simulator(int argc, char *argv[])
@@ -30,6 +45,11 @@ Simulator::Simulator(int argc, char *argv[])
 // Destructor
 Simulator::~Simulator()
 {
+    // Finish writing the results log, journal and result cache before any plugin is unloaded
+    resultsLog.reset();
+    journal.reset();
+    resultCache.reset();
+    pluginCache.reset();
     board.reset();
     AlgorithmRegistrar::getAlgorithmRegistrar().clear();
     GameManagerRegistrar::getGameManagerRegistrar().clear();
@@ -51,6 +71,7 @@ bool Simulator::loadBoard(const std::string &path)
         return false;
     }
 
+    TraceRecorder::Span span("load map");
     board = make_unique<GameBoard>(path);
     if (!board->isValid())
     {
@@ -59,8 +80,34 @@ bool Simulator::loadBoard(const std::string &path)
     return true;
 }
 
-// Load so file
-void Simulator::loadSharedObjectFromFile(const std::string &filePath, SharedObjectType type)
+// File names in a directory in sorted order, optionally only those with the given extension.
+// Algorithms and maps are always taken in this order, so task ids do not depend on the filesystem.
+std::vector<std::string> sortedDirectoryFiles(const std::string &directoryPath, const std::string &extension)
+{
+    if (!fs::exists(directoryPath) || !fs::is_directory(directoryPath))
+        throw std::runtime_error("Directory does not exist or is not a directory: " + directoryPath);
+
+    std::vector<std::string> files;
+    for (const auto &entry : fs::directory_iterator(directoryPath))
+    {
+        if (!entry.is_regular_file())
+            continue;
+        if (!extension.empty() && entry.path().extension() != extension)
+            continue;
+        files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// Load so file; returns the milliseconds spent in dlopen, which includes the plugin's static initializers.
+// Plugins are opened RTLD_LOCAL, and the simulator exports only the registration symbols (exports.list):
+// each plugin binds to those and to its own copy of UserCommon, and none of its symbols are searched while
+// later plugins are resolved. With
+// plugin_cache=, a plugin that failed to register before is skipped unopened, and one that registered
+// before is bound lazily, since its symbols are already known to resolve. loadFrom, if given, is a copy
+// of filePath that is opened instead; the plugin is still named and cached after filePath.
+double Simulator::loadSharedObjectFromFile(const std::string &filePath, SharedObjectType type, const std::string &loadFrom)
 {
     namespace fs = std::filesystem;
 
@@ -72,6 +119,10 @@ void Simulator::loadSharedObjectFromFile(const std::string &filePath, SharedObje
 
     const std::string baseName = fs::path(filePath).stem().string();
 
+    const PluginCache::Entry *known = pluginCache ? pluginCache->lookup(filePath) : nullptr;
+    if (known && known->status == PluginCache::Status::BAD)
+        throw std::runtime_error("Failed to register in an earlier run and has not changed since (plugin_cache): " + filePath);
+
     // Create registrar entry before loading
     if (type == SharedObjectType::Algorithm)
     {
@@ -84,10 +135,15 @@ void Simulator::loadSharedObjectFromFile(const std::string &filePath, SharedObje
         gmRegistrar.createFactoryEntry(baseName);
     }
 
-    void *handle = dlopen(filePath.c_str(), RTLD_NOW | RTLD_GLOBAL);
+    auto start = std::chrono::steady_clock::now();
+    const std::string &openPath = loadFrom.empty() ? filePath : loadFrom;
+    void *handle = dlopen(openPath.c_str(), (known ? RTLD_LAZY : RTLD_NOW) | RTLD_LOCAL);
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
     if (!handle)
     {
         std::string err = dlerror();
+        if (pluginCache)
+            pluginCache->record(filePath, PluginCache::Status::BAD);
         if (type == SharedObjectType::Algorithm)
             AlgorithmRegistrar::getAlgorithmRegistrar().removeLast();
         else
@@ -99,18 +155,28 @@ void Simulator::loadSharedObjectFromFile(const std::string &filePath, SharedObje
     soHandles.push_back(handle);
 
     // Validate registration
+    PluginCache::Status status = PluginCache::Status::BAD;
+    std::ostringstream timing;
+    timing << " (" << std::fixed << std::setprecision(1) << loadMs << " ms" << (known ? ", cached" : "") << ")";
     try
     {
         if (type == SharedObjectType::Algorithm)
         {
             AlgorithmRegistrar::getAlgorithmRegistrar().validateLastRegistration();
-            std::cout << "Successfully registered Algorithm factories for: " << baseName << std::endl;
+            std::cout << "Successfully registered Algorithm factories for: " << baseName << timing.str() << std::endl;
         }
         else
         {
             GameManagerRegistrar::getGameManagerRegistrar().validateLastRegistration();
-            std::cout << "Successfully registered GameManager factory for: " << baseName << std::endl;
+            std::cout << "Successfully registered GameManager factory for: " << baseName << timing.str() << std::endl;
+            // Optional; a game manager that exports it shows its steps in the trace
+            if (tracer)
+            {
+                if (void *setter = dlsym(handle, "tankgame_set_step_observer"))
+                    stepObservers[baseName] = reinterpret_cast<TraceRecorder::StepObserverSetter>(setter);
+            }
         }
+        status = PluginCache::Status::VALID;
     }
     catch (const AlgorithmRegistrar::BadRegistrationException &e)
     {
@@ -129,6 +195,10 @@ void Simulator::loadSharedObjectFromFile(const std::string &filePath, SharedObje
                   << std::endl;
         GameManagerRegistrar::getGameManagerRegistrar().removeLast();
     }
+
+    if (pluginCache)
+        pluginCache->record(filePath, status);
+    return loadMs;
 }
 
 // Load all so files from directory
@@ -140,25 +210,35 @@ void Simulator::loadSharedObjectsFromDirectory(const std::string &directoryPath,
         throw std::runtime_error("Directory does not exist or is not a directory: " + directoryPath);
 
     size_t files_loaded_count = 0;
+    double totalMs = 0;
+    double slowestMs = -1;
+    std::string slowest;
 
-    for (const auto &entry : fs::directory_iterator(directoryPath))
+    for (const auto &file : sortedDirectoryFiles(directoryPath, ".so"))
     {
-        if (!entry.is_regular_file() || entry.path().extension() != ".so")
-            continue;
-
         try
         {
-            loadSharedObjectFromFile(entry.path().string(), type);
+            double ms = loadSharedObjectFromFile(file, type);
             files_loaded_count++;
+            totalMs += ms;
+            if (ms > slowestMs)
+            {
+                slowestMs = ms;
+                slowest = fs::path(file).stem().string();
+            }
         }
         catch (const std::exception &e)
         {
-            std::cerr << "Skipping file " << entry.path() << " due to error: " << e.what() << std::endl;
+            std::cerr << "Skipping file " << fs::path(file) << " due to error: " << e.what() << std::endl;
         }
     }
 
     if (files_loaded_count == 0)
         throw std::runtime_error("Directory '" + directoryPath + "' does not contain any valid .so files.");
+
+    std::cout << "Loaded " << files_loaded_count << " shared objects from " << directoryPath << " in "
+              << std::fixed << std::setprecision(1) << totalMs << " ms, slowest " << slowest << " (" << slowestMs << " ms)"
+              << std::defaultfloat << std::endl;
 }
 
 // Serialize the final game state into a string
@@ -176,11 +256,83 @@ std::string gameStateToString(const GameResult &result, size_t width, size_t hei
     return oss.str();
 }
 
+void openResultFile(std::ofstream &out, const std::string &outputFile)
+{
+    out.open(outputFile);
+    if (!out)
+    {
+        std::cerr << "Cannot create output file: " << outputFile << ", printing to screen.\n";
+        out.basic_ios<char>::rdbuf(std::cout.rdbuf());
+    }
+}
+
+void writeCompetitionResults(std::ostream &out, const std::string &mapsFolder, const std::string &gameManager,
+                             const std::string &shardHeader, const std::map<std::string, int> &scores)
+{
+    out << "game_maps_folder=" << mapsFolder << "\n";
+    out << "game_manager=" << gameManager << "\n";
+    if (!shardHeader.empty())
+        out << shardHeader << "\n";
+    out << "\n";
+
+    std::vector<std::pair<std::string, int>> scoreVec(scores.begin(), scores.end());
+    std::sort(scoreVec.begin(), scoreVec.end(), [](const auto &a, const auto &b)
+              { return b.second < a.second; });
+
+    for (const auto &[name, score] : scoreVec)
+    {
+        out << name << " " << score << "\n";
+    }
+}
+
+void writeComparativeResults(std::ostream &out, const std::string &gameMap, const std::string &algorithm1,
+                             const std::string &algorithm2, const std::map<std::string, ComparativeResult> &groupedResults)
+{
+    out << "game_map=" << gameMap << "\n";
+    out << "algorithm1=" << algorithm1 << "\n";
+    out << "algorithm2=" << algorithm2 << "\n\n";
+
+    bool first = true;
+    for (const auto &[key, group] : groupedResults)
+    {
+        if (!first)
+            out << "\n";
+        first = false;
+
+        for (size_t i = 0; i < group.gmNames.size(); i++)
+        {
+            if (i > 0)
+                out << ",";
+            out << group.gmNames[i];
+        }
+        out << "\n";
+
+        if (group.result.winner == 0)
+        {
+            if (group.result.reason == GameResult::Reason::ALL_TANKS_DEAD)
+                out << "Tie, reason: ALL_TANKS_DEAD\n";
+            else if (group.result.reason == GameResult::Reason::MAX_STEPS)
+                out << "Tie, reason: MAX_STEPS\n";
+            else if (group.result.reason == GameResult::Reason::ZERO_SHELLS)
+                out << "Tie, reason: ZERO_SHELLS\n";
+        }
+        else
+        {
+            out << "Player " << group.result.winner << " won, reason: ALL_TANKS_DEAD\n";
+        }
+
+        out << group.result.rounds << "\n";
+        out << group.finalState << "\n";
+    }
+}
+
 // Run Comparative
 void Simulator::runComparative(bool verbose)
 {
     auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
     auto &gmRegistrar = GameManagerRegistrar::getGameManagerRegistrar();
+    if (tracer)
+        tracer->attachThread("main");
 
     loadSharedObjectFromFile(params.at("algorithm1"), SharedObjectType::Algorithm);
     loadSharedObjectFromFile(params.at("algorithm2"), SharedObjectType::Algorithm);
@@ -196,77 +348,52 @@ void Simulator::runComparative(bool verbose)
     std::string timeStr = getTimeString();
     std::string outputFile = outputFolder + "/comparative_results_" + timeStr + ".txt";
 
-    std::ofstream out(outputFile);
-    if (!out)
+    std::unique_ptr<Player> p1, p2;
     {
-        std::cerr << "Cannot create output file: " << outputFile << ", printing to screen.\n";
-        out.basic_ios<char>::rdbuf(std::cout.rdbuf());
+        TraceRecorder::Span span("create players");
+        p1 = registrar.getAlgorithm(0).createPlayer(1, board->getWidth(), board->getHeight(), board->getMaxSteps(), 0);
+        p2 = registrar.getAlgorithm(1).createPlayer(2, board->getWidth(), board->getHeight(), board->getMaxSteps(), 0);
     }
 
-    out << "game_map=" << mapFile << "\n";
-    out << "algorithm1=" << params.at("algorithm1") << "\n";
-    out << "algorithm2=" << params.at("algorithm2") << "\n\n";
-
-    auto p1 = registrar.getAlgorithm(0).createPlayer(1, board->getWidth(), board->getHeight(), board->getMaxSteps(), 0);
-    auto p2 = registrar.getAlgorithm(1).createPlayer(2, board->getWidth(), board->getHeight(), board->getMaxSteps(), 0);
-
     std::map<std::string, ComparativeResult> groupedResults;
 
     for (auto &gmEntry : gmRegistrar.getGM())
     {
+        auto mapName = fs::path(mapFile).stem().string();
+        TraceRecorder::Span gameSpan("game");
+        if (tracer)
+            gameSpan.setArgs(TraceRecorder::args({{"map", mapName}, {"game_manager", gmEntry.name}}));
         auto gm = gmEntry.create(verbose);
         auto sat = SatelliteViewImpl(*board, Position(-1, -1));
-        auto mapName = fs::path(mapFile).stem().string();
 
-        GameResult result = gm->run(
-            board->getWidth(), board->getHeight(),
-            dynamic_cast<SatelliteView &>(sat), mapName,
-            board->getMaxSteps(), board->getNumShells(),
-            *p1, registrar.getAlgorithm(0).name(),
-            *p2, registrar.getAlgorithm(1).name(),
-            registrar.getAlgorithm(0).getTankAlgorithmFactory(),
-            registrar.getAlgorithm(1).getTankAlgorithmFactory());
+        GameResult result;
+        {
+            TraceRecorder::Span span("gm.run");
+            TraceRecorder::StepSpans steps(stepObserverOf(gmEntry.name));
+            result = gm->run(
+                board->getWidth(), board->getHeight(),
+                dynamic_cast<SatelliteView &>(sat), mapName,
+                board->getMaxSteps(), board->getNumShells(),
+                *p1, registrar.getAlgorithm(0).name(),
+                *p2, registrar.getAlgorithm(1).name(),
+                registrar.getAlgorithm(0).getTankAlgorithmFactory(),
+                registrar.getAlgorithm(1).getTankAlgorithmFactory());
+        }
 
+        std::string finalState = gameStateToString(result, board->getWidth(), board->getHeight());
         std::ostringstream sig;
-        sig << result.winner << "|" << result.reason << "|" << result.rounds << "|"
-            << gameStateToString(result, board->getWidth(), board->getHeight());
+        sig << result.winner << "|" << result.reason << "|" << result.rounds << "|" << finalState;
 
         std::string key = sig.str();
         groupedResults[key].result = move(result);
         groupedResults[key].gmNames.push_back(gmEntry.name);
+        groupedResults[key].finalState = finalState;
         loadBoard(mapFile);
     }
 
-    bool first = true;
-    for (auto &[key, group] : groupedResults)
-    {
-        if (!first)
-            out << "\n";
-        first = false;
-
-        for (size_t i = 0; i < group.gmNames.size(); i++)
-        {
-            if (i > 0)
-                out << ",";
-            out << group.gmNames[i];
-        }
-        out << "\n";
-
-        if (group.result.winner == 0)
-        {
-            if (group.result.reason == GameResult::Reason::ALL_TANKS_DEAD)
-                out << "Tie, reason: ALL_TANKS_DEAD" << "\n";
-            else if (group.result.reason == GameResult::Reason::MAX_STEPS)
-                out << "Tie, reason: MAX_STEPS" << "\n";
-            else if (group.result.reason == GameResult::Reason::ZERO_SHELLS)
-                out << "Tie, reason: ZERO_SHELLS" << "\n";
-        }
-        else
-            out << "Player " << group.result.winner << " won, reason: ALL_TANKS_DEAD" << "\n";
-
-        out << group.result.rounds << "\n";
-        out << gameStateToString(group.result, board->getWidth(), board->getHeight()) << "\n";
-    }
+    std::ofstream out;
+    openResultFile(out, outputFile);
+    writeComparativeResults(out, mapFile, params.at("algorithm1"), params.at("algorithm2"), groupedResults);
 }
 
 // Run Competition
@@ -274,10 +401,12 @@ void Simulator::runCompetition(bool verbose)
 {
     auto &gmRegistrar = GameManagerRegistrar::getGameManagerRegistrar();
     auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
-    loadSharedObjectsFromDirectory(params.at("algorithms_folder"), SharedObjectType::Algorithm);
+    if (tracer)
+        tracer->attachThread("main");
+    loadCompetitionAlgorithms();
     loadSharedObjectFromFile(params.at("game_manager"), SharedObjectType::GameManager);
     cout << registrar.count() << " algorithms registered.\n";
-    if (registrar.count() < 2)
+    if (registrar.count() < 2 && shardCount <= 1)
     {
         throw std::runtime_error("At least two algorithms are required for competition mode.");
     }
@@ -288,23 +417,8 @@ void Simulator::runCompetition(bool verbose)
 
     string timeStr = getTimeString();
     string outputFile = algFolder + "/competition_" + timeStr + ".txt";
-    ofstream out(outputFile);
-    if (!out)
-    {
-        cerr << "Cannot create output file: " << outputFile << ", printing to screen.\n";
-        out.basic_ios<char>::rdbuf(cout.rdbuf());
-    }
 
-    out << "game_maps_folder=" << mapFolder << "\n";
-    out << "game_manager=" << gmSO << "\n\n";
-
-    map<string, int> scores;
-    for (size_t i = 0; i < registrar.count(); ++i)
-        scores[registrar.getAlgorithm(i).name()] = 0;
-
-    vector<string> maps;
-    for (auto &p : fs::directory_iterator(mapFolder))
-        maps.push_back(p.path().string());
+    vector<string> maps = sortedDirectoryFiles(mapFolder, "");
 
     const auto &gmList = gmRegistrar.getGM();
     if (gmList.empty())
@@ -315,61 +429,55 @@ void Simulator::runCompetition(bool verbose)
     auto gm = gmFactory(verbose);
 
     size_t N = registrar.count();
-    for (size_t k = 0; k < maps.size(); ++k)
+    CompetitionTasks tasks = makeCompetitionTasks(maps, N);
+    vector<AlgorithmStats> stats = resumeFromJournal(tasks, registeredAlgorithmNames());
+    openResultCache(registeredAlgorithmNames());
+
+    std::atomic<uint64_t> queued{tasks.size()};
+    auto reporter = startMetrics(1, tasks.size() - journaledGames(), [&queued]
+                                 { return queued.load(); });
+    measurePeakRss = true;
+
+    string loadedMap;
+    bool mapValid = false;
+    TaskRange ids = tasks.idRange();
+    for (uint64_t taskId = ids.begin; taskId < ids.end; ++taskId)
     {
-        if (!loadBoard(maps[k]))
+        queued.store(ids.end - taskId - 1);
+        GameTask task = tasks.byId(taskId);
+        if (mapFiles[task.mapIndex] != loadedMap)
         {
-            cout << "Skipping invalid map: " << maps[k] << "\n";
-            continue;
+            loadedMap = mapFiles[task.mapIndex];
+            mapValid = loadBoard(loadedMap);
+            if (!mapValid)
+                cout << "Skipping invalid map: " << loadedMap << "\n";
         }
-
-        std::set<std::pair<size_t, size_t>> playedPairs;
-
-        for (size_t i = 0; i < N; ++i)
+        if (alreadyPlayed(task))
+            continue;
+        if (!mapValid)
         {
-            size_t j = (i + 1 + k % (N - 1)) % N;
-            if (i == j)
-                continue;
-            auto pair = std::minmax(i, j);
-            if (playedPairs.count(pair))
-                continue;
-
-            auto p1 = registrar.getAlgorithm(i).createPlayer(1, board->getWidth(), board->getHeight(), board->getMaxSteps(), 0);
-            auto p2 = registrar.getAlgorithm(j).createPlayer(2, board->getWidth(), board->getHeight(), board->getMaxSteps(), 0);
-            auto sat = SatelliteViewImpl(*board, Position(-1, -1));
-            auto mapName = fs::path(maps[k]).stem().string();
-
-            GameResult result = gm->run(
-                board->getWidth(), board->getHeight(),
-                dynamic_cast<SatelliteView &>(sat), mapName,
-                board->getMaxSteps(), board->getNumShells(),
-                *p1, registrar.getAlgorithm(i).name(),
-                *p2, registrar.getAlgorithm(j).name(),
-                registrar.getAlgorithm(i).getTankAlgorithmFactory(),
-                registrar.getAlgorithm(j).getTankAlgorithmFactory());
-
-            playedPairs.insert(pair);
-
-            if (result.winner == 0)
-            {
-                scores[registrar.getAlgorithm(i).name()] += 1;
-                scores[registrar.getAlgorithm(j).name()] += 1;
-            }
-            else
-            {
-                scores[result.winner == 1 ? registrar.getAlgorithm(i).name() : registrar.getAlgorithm(j).name()] += 3;
-            }
+            recordMetrics(0, GameOutcome());
+            continue;
         }
-    }
 
-    vector<pair<string, int>> scoreVec(scores.begin(), scores.end());
-    sort(scoreVec.begin(), scoreVec.end(), [](auto &a, auto &b)
-         { return b.second < a.second; });
-
-    for (auto &[name, score] : scoreVec)
-        out << name << " " << score << "\n";
+        if (metrics)
+            metrics->gameStarted(0);
+        GameOutcome outcome = playGameTask(*gm, task, loadedMap, board);
+        recordMetrics(0, outcome);
+        addGameResult(stats, task, outcome.winner, outcome.rounds);
+        logGame(task, registrar.getAlgorithm(task.player1_idx).name(), registrar.getAlgorithm(task.player2_idx).name(), outcome);
+    }
 
-    out.close();
+    map<string, int> scores;
+    for (size_t i = 0; i < N; ++i)
+        scores[registrar.getAlgorithm(i).name()] += stats[i].score;
+    // A shard lists every algorithm, so merging sees all of them even if one plays in no shard
+    for (const auto &name : shardAlgorithmNames)
+        scores.try_emplace(name, 0);
+
+    ofstream out;
+    openResultFile(out, outputFile);
+    writeCompetitionResults(out, mapFolder, gmSO, shardHeader, scores);
 }
 
 // Validate required parameters
@@ -388,6 +496,112 @@ void Simulator::validateRequiredParams()
         checkParamExists("game_manager");
         checkParamExists("algorithms_folder");
     }
+
+    else if (mode == RunMode::COORDINATOR)
+    {
+        checkParamExists("game_maps_folder");
+        checkParamExists("game_manager");
+        checkParamExists("algorithms_folder");
+        checkParamExists("port");
+    }
+    else if (mode == RunMode::WORKER)
+    {
+        checkParamExists("game_maps_folder");
+        checkParamExists("game_manager");
+        checkParamExists("algorithms_folder");
+        checkParamExists("coordinator");
+    }
+    else if (mode == RunMode::DAEMON)
+    {
+        checkParamExists("socket");
+    }
+    else if (mode == RunMode::MERGE)
+    {
+        checkParamExists("shards_folder");
+    }
+
+    // A run handed to a daemon only carries what a daemon job can do
+    if (params.count("daemon"))
+    {
+        if (mode != RunMode::COMPETITION && mode != RunMode::COMPARATIVE)
+            throw invalid_argument("daemon is only supported in competition and comparative mode");
+        for (const auto &[key, value] : params)
+        {
+            if (key != "daemon" && key != "round_robin" && key != "game_map" && key != "game_managers_folder" && key != "algorithm1" &&
+                key != "algorithm2" && key != "game_maps_folder" && key != "game_manager" && key != "algorithms_folder")
+                throw invalid_argument(key + " is not supported together with daemon");
+        }
+        if (numProcesses > 1)
+            throw invalid_argument("num_processes is not supported together with daemon");
+    }
+
+    if (params.count("results_log") && mode != RunMode::COMPETITION && mode != RunMode::COORDINATOR)
+        throw invalid_argument("results_log is only supported in competition and coordinator mode");
+    if (params.count("journal") && mode != RunMode::COMPETITION && mode != RunMode::COORDINATOR)
+        throw invalid_argument("journal is only supported in competition and coordinator mode");
+    if (params.count("round_robin") && mode != RunMode::COMPETITION && mode != RunMode::COORDINATOR)
+        throw invalid_argument("round_robin is only supported in competition and coordinator mode");
+    if (params.count("round_robin") && params.at("round_robin") != "full" && params.at("round_robin") != "rotation")
+        throw invalid_argument("round_robin must be full or rotation");
+    if (params.count("result_cache") && mode != RunMode::COMPETITION && mode != RunMode::COORDINATOR)
+        throw invalid_argument("result_cache is only supported in competition and coordinator mode");
+    if ((params.count("deterministic") || params.count("cache_verify")) && !params.count("result_cache"))
+        throw invalid_argument("deterministic and cache_verify require result_cache");
+    if (params.count("cache_verify"))
+    {
+        double percent = -1;
+        try
+        {
+            percent = std::stod(params.at("cache_verify"));
+        }
+        catch (const std::exception &)
+        {
+        }
+        if (percent < 0 || percent > 100)
+            throw invalid_argument("Invalid cache_verify value: " + params.at("cache_verify"));
+    }
+    if ((params.count("progress") || params.count("metrics_file")) && mode != RunMode::COMPETITION && mode != RunMode::COORDINATOR)
+        throw invalid_argument("progress and metrics_file are only supported in competition and coordinator mode");
+    if (params.count("progress"))
+    {
+        double interval = 0;
+        try
+        {
+            interval = std::stod(params.at("progress"));
+        }
+        catch (const std::exception &)
+        {
+        }
+        if (interval <= 0)
+            throw invalid_argument("Invalid progress value: " + params.at("progress"));
+    }
+    if (params.count("shard"))
+    {
+        if (mode != RunMode::COMPETITION)
+            throw invalid_argument("shard is only supported in competition mode");
+        const std::string &shard = params.at("shard");
+        size_t slash = shard.find('/');
+        auto isNumber = [](const std::string &text)
+        { return !text.empty() && text.size() < 10 && text.find_first_not_of("0123456789") == std::string::npos; };
+        if (slash == std::string::npos || !isNumber(shard.substr(0, slash)) || !isNumber(shard.substr(slash + 1)))
+            throw invalid_argument("Invalid shard value: " + shard + ", expected i/n");
+        shardIndex = std::stoul(shard.substr(0, slash));
+        shardCount = std::stoul(shard.substr(slash + 1));
+        if (shardCount == 0 || shardIndex >= shardCount)
+            throw invalid_argument("Invalid shard value: " + shard + ", expected i/n with 0 <= i < n");
+    }
+    if (params.count("memory_budget_mb"))
+    {
+        const std::string &budget = params.at("memory_budget_mb");
+        if (budget.empty() || budget.find_first_not_of("0123456789") != std::string::npos)
+            throw invalid_argument("Invalid memory_budget_mb value: " + budget);
+    }
+    if (params.count("trace") && mode != RunMode::COMPETITION && mode != RunMode::COMPARATIVE)
+        throw invalid_argument("trace is only supported in competition and comparative mode");
+    if (numProcesses > 1 && mode != RunMode::COMPETITION)
+        throw invalid_argument("num_processes is only supported in competition mode");
+    if (numProcesses > 1 && numThreads > 1)
+        throw invalid_argument("num_threads and num_processes cannot be combined");
 }
 
 // Check if parameter exists
@@ -425,6 +639,26 @@ void Simulator::parseArguments(int argc, char *argv[])
             mode = RunMode::COMPETITION;
             mode_updated = true;
         }
+        else if (arg == "-coordinator")
+        {
+            mode = RunMode::COORDINATOR;
+            mode_updated = true;
+        }
+        else if (arg == "-worker")
+        {
+            mode = RunMode::WORKER;
+            mode_updated = true;
+        }
+        else if (arg == "-daemon")
+        {
+            mode = RunMode::DAEMON;
+            mode_updated = true;
+        }
+        else if (arg == "-merge")
+        {
+            mode = RunMode::MERGE;
+            mode_updated = true;
+        }
         else if (arg == "-verbose")
             verbose = true;
         else if (arg.find("num_threads=") == 0)
@@ -453,13 +687,34 @@ void Simulator::parseArguments(int argc, char *argv[])
                 throw std::invalid_argument("Invalid num_threads value: " + value);
             }
         }
+        else if (arg.find("num_processes=") == 0)
+        {
+            std::string value = arg.substr(arg.find('=') + 1);
+            try
+            {
+                numProcesses = std::stoi(value);
+            }
+            catch (const std::exception &)
+            {
+                throw std::invalid_argument("Invalid num_processes value: " + value);
+            }
+            if (numProcesses < 1)
+                throw std::invalid_argument("Invalid num_processes value: " + value);
+        }
         else
         {
             size_t eqPos = arg.find('=');
             if (eqPos == std::string::npos)
                 throw std::invalid_argument("Invalid argument format: " + arg);
             std::string key = arg.substr(0, eqPos);
-            if (key != "game_map" && key != "game_managers_folder" && key != "algorithm1" && key != "algorithm2" && key != "game_maps_folder" && key != "game_manager" && key != "algorithms_folder")
+            if (key != "game_map" && key != "game_managers_folder" && key != "algorithm1" && key != "algorithm2" && key != "game_maps_folder" && key != "game_manager" && key != "algorithms_folder" &&
+                key != "process_memory_mb" && key != "process_cpu_sec" &&
+                key != "port" && key != "coordinator" && key != "batch_size" && key != "batch_timeout_sec" && key != "results_log" &&
+                key != "journal" && key != "round_robin" &&
+                key != "result_cache" && key != "deterministic" && key != "cache_verify" &&
+                key != "progress" && key != "metrics_file" && key != "plugin_cache" &&
+                key != "socket" && key != "daemon" && key != "memory_budget_mb" &&
+                key != "shard" && key != "shards_folder" && key != "trace")
             {
                 throw std::invalid_argument("Unsupported argument:" + key);
             }
@@ -469,7 +724,7 @@ void Simulator::parseArguments(int argc, char *argv[])
     }
     if (!mode_updated)
     {
-        throw std::invalid_argument("missing -comparative or -competition");
+        throw std::invalid_argument("missing -comparative, -competition, -coordinator, -worker, -daemon or -merge");
     }
     validateRequiredParams();
 }
@@ -477,9 +732,32 @@ void Simulator::parseArguments(int argc, char *argv[])
 // Run the simulator
 void Simulator::run(bool verbose)
 {
+    if (params.count("daemon"))
+    {
+        submitToDaemon();
+        return;
+    }
+
+    if (params.count("plugin_cache"))
+    {
+        pluginCache = std::make_unique<PluginCache>(params.at("plugin_cache"));
+    }
+    if (params.count("results_log"))
+    {
+        resultsLog = std::make_unique<ResultsLog>(params.at("results_log"));
+    }
+    if (params.count("trace"))
+    {
+        tracer = std::make_unique<TraceRecorder>(params.at("trace"));
+    }
+
     if (mode == RunMode::COMPETITION)
     {
-        if (numThreads == 1)
+        if (numProcesses > 1)
+        {
+            runCompetitionProcesses(verbose);
+        }
+        else if (numThreads == 1)
         {
             runCompetition(verbose);
         }
@@ -499,10 +777,39 @@ void Simulator::run(bool verbose)
             runComparativeThreaded(verbose);
         }
     }
+    else if (mode == RunMode::COORDINATOR)
+    {
+        runCoordinator();
+    }
+    else if (mode == RunMode::WORKER)
+    {
+        runWorker(verbose);
+    }
+    else if (mode == RunMode::DAEMON)
+    {
+        runDaemon();
+    }
+    else if (mode == RunMode::MERGE)
+    {
+        mergeShards();
+    }
     else
     {
         throw std::runtime_error("Unknown run mode");
     }
+
+    // Every thread that recorded has finished, and so has every worker process
+    if (tracer)
+    {
+        TraceRecorder::detachThread();
+        tracer->write();
+    }
+
+    if (resultCache)
+    {
+        std::cout << "Result cache: " << cacheHits << " games reused, " << cacheVerified + cacheMismatches
+                  << " replayed to verify, " << cacheMismatches << " mismatches.\n";
+    }
 }
 
 // Determine optimal thread count
@@ -528,6 +835,7 @@ int Simulator::getOptimalThreadCount(size_t totalTasks) const
 // Create a new GameBoard instance
 std::unique_ptr<GameBoard> Simulator::createGameBoard(const std::string &mapFile) const
 {
+    TraceRecorder::Span span("load map");
     auto gameBoard = std::make_unique<GameBoard>(mapFile);
     if (!gameBoard->isValid())
     {
@@ -536,189 +844,1567 @@ std::unique_ptr<GameBoard> Simulator::createGameBoard(const std::string &mapFile
     return gameBoard;
 }
 
-// Competition task structure
-void Simulator::runCompetitionThreaded(bool verbose)
+// Size, MaxSteps and tank count of a map, read from its header and grid; false if the header is malformed
+static bool readMapShape(const std::string &mapFile, size_t &rows, size_t &cols, size_t &maxSteps, size_t &tanks)
 {
-    auto &gmRegistrar = GameManagerRegistrar::getGameManagerRegistrar();
-    (void)gmRegistrar;
-    auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    std::ifstream in(mapFile);
+    std::string line;
+    size_t numShells = 0;
+    if (!std::getline(in, line) ||
+        !std::getline(in, line) || sscanf(line.c_str(), "MaxSteps = %zu", &maxSteps) != 1 ||
+        !std::getline(in, line) || sscanf(line.c_str(), "NumShells = %zu", &numShells) != 1 ||
+        !std::getline(in, line) || sscanf(line.c_str(), "Rows = %zu", &rows) != 1 ||
+        !std::getline(in, line) || sscanf(line.c_str(), "Cols = %zu", &cols) != 1)
+    {
+        return false;
+    }
 
-    // Load shared objects
-    loadSharedObjectsFromDirectory(params.at("algorithms_folder"), SharedObjectType::Algorithm);
-    loadSharedObjectFromFile(params.at("game_manager"), SharedObjectType::GameManager);
-    std::cout << registrar.count() << " algorithms registered.\n";
-    if (registrar.count() < 2)
+    tanks = 0;
+    for (size_t y = 0; y < rows && std::getline(in, line); ++y)
     {
-        throw std::runtime_error("At least two algorithms are required for competition mode.");
+        for (size_t x = 0; x < cols && x < line.size(); ++x)
+        {
+            if (line[x] == '1' || line[x] == '2')
+                ++tanks;
+        }
     }
+    return true;
+}
 
-    std::string mapFolder = params.at("game_maps_folder");
+// Estimate the work of one game on a map: area x MaxSteps x tank count
+size_t Simulator::estimateTaskCost(const std::string &mapFile) const
+{
+    size_t rows = 0, cols = 0, maxSteps = 0, tanks = 0;
+    if (!readMapShape(mapFile, rows, cols, maxSteps, tanks))
+        return 0;
+    return rows * cols * maxSteps * std::max<size_t>(tanks, 1);
+}
+
+// Estimate the memory of one game on a map. Measured with the bundled game manager and algorithms, the
+// board with its copies takes about 48 bytes per cell, and every tank about 12 more per cell for the
+// view its algorithm keeps; a game also needs about 1 MB whatever the map.
+uint64_t Simulator::estimateTaskMemory(const std::string &mapFile) const
+{
+    size_t rows = 0, cols = 0, maxSteps = 0, tanks = 0;
+    if (!readMapShape(mapFile, rows, cols, maxSteps, tanks))
+        return 0;
+    return static_cast<uint64_t>(rows) * cols * (48 + 12 * tanks) + (1 << 20);
+}
+
+// Budget of the memory gate: memory_budget_mb=, 0 to turn it off, or else 80% of the memory available now
+void Simulator::openMemoryGate(MemoryGate::State &state, size_t workers)
+{
+    uint64_t budget = MemoryGate::availableBytes() / 10 * 8;
+    if (params.count("memory_budget_mb"))
+        budget = std::stoull(params.at("memory_budget_mb")) << 20;
+    memoryGate = std::make_unique<MemoryGate>(state, budget);
+
+    uint64_t largest = mapMemory.empty() ? 0 : *std::max_element(mapMemory.begin(), mapMemory.end());
+    if (budget > 0 && largest * workers > budget)
+    {
+        std::cout << "Memory budget " << (budget >> 20) << " MB: the largest games (about " << (largest >> 20)
+                  << " MB each) run at most " << std::max<uint64_t>(budget / std::max<uint64_t>(largest, 1), 1) << " at a time\n";
+    }
+}
+
+// Longest games first: maps come in scheduling order (decreasing cost) and all games of a map go,
+// as one range, to the worker with the least work assigned so far, so its board stays cached there
+void Simulator::distributeTasks(const CompetitionTasks &tasks, WorkStealingScheduler<TaskRange> &scheduler) const
+{
+    std::vector<uint64_t> load(scheduler.workerCount(), 0);
+    for (size_t i = 0; i < tasks.mapCount(); ++i)
+    {
+        TaskRange range = tasks.mapRange(i);
+        if (range.begin == range.end)
+            continue;
+        size_t worker = std::min_element(load.begin(), load.end()) - load.begin();
+        load[worker] += tasks.mapRangeCost(i);
+        scheduler.push(worker, range);
+    }
+}
+
+CompetitionTasks::Pairing Simulator::competitionPairing() const
+{
+    if (params.count("round_robin") && params.at("round_robin") == "full")
+        return CompetitionTasks::Pairing::FullRoundRobin;
+    return CompetitionTasks::Pairing::Rotation;
+}
+
+// The games of a competition over the given maps; round_robin=full plays every ordered pair on every map.
+// A shard numbers its games over every algorithm file, loaded or not, and only estimates the maps it plays
+// on; its fingerprint (loadCompetitionAlgorithms) still reads every map and algorithm file in full.
+CompetitionTasks Simulator::makeCompetitionTasks(const std::vector<std::string> &maps, size_t algorithmCount)
+{
+    if (shardCount > 1)
+        algorithmCount = playerSlots.size();
+    CompetitionTasks shape(algorithmCount, std::vector<uint64_t>(maps.size(), 0), competitionPairing(), shardIndex, shardCount);
+
+    mapFiles = maps;
+    std::vector<uint64_t> costs;
+    mapMemory.clear();
+    for (size_t k = 0; k < maps.size(); ++k)
+    {
+        bool played = shape.gamesInShard(k) > 0;
+        costs.push_back(played ? estimateTaskCost(maps[k]) : 0);
+        mapMemory.push_back(played ? estimateTaskMemory(maps[k]) : 0);
+    }
+
+    CompetitionTasks tasks(algorithmCount, std::move(costs), competitionPairing(), shardIndex, shardCount);
+    if (shardCount > 1)
+        tasks.setPlayerSlots(playerSlots);
+    return tasks;
+}
+
+// The algorithms of a competition. A shard only loads those its games are played with, and every one
+// of them must register, since the other shards could not know that it failed.
+void Simulator::loadCompetitionAlgorithms()
+{
+    const std::string &folder = params.at("algorithms_folder");
+    if (shardCount <= 1)
+    {
+        loadSharedObjectsFromDirectory(folder, SharedObjectType::Algorithm);
+        return;
+    }
+
+    std::vector<std::string> files = sortedDirectoryFiles(folder, ".so");
+    std::vector<std::string> maps = sortedDirectoryFiles(params.at("game_maps_folder"), "");
+    if (files.size() < 2)
+        throw std::runtime_error("At least two algorithms are required for competition mode.");
+
+    CompetitionTasks shape(files.size(), std::vector<uint64_t>(maps.size(), 0), competitionPairing(), shardIndex, shardCount);
+    std::vector<char> needed(files.size(), 0);
+    size_t neededCount = 0;
+    for (uint64_t position = 0; position < shape.size() && neededCount < files.size(); ++position)
+    {
+        GameTask task = shape.at(position);
+        for (size_t index : {task.player1_idx, task.player2_idx})
+        {
+            if (!needed[index])
+                neededCount++;
+            needed[index] = 1;
+        }
+    }
+
+    auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    playerSlots.assign(files.size(), 0);
+    shardAlgorithmNames.clear();
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        shardAlgorithmNames.push_back(fs::path(files[i]).stem().string());
+        if (!needed[i])
+            continue;
+        size_t before = registrar.count();
+        loadSharedObjectFromFile(files[i], SharedObjectType::Algorithm);
+        if (registrar.count() == before)
+            throw std::runtime_error("Algorithm " + files[i] + " is needed by shard " + params.at("shard") + " but did not register");
+        playerSlots[i] = before;
+    }
+
+    // Shard files of one competition carry the same fingerprint of what decides its games, with every
+    // algorithm file, loaded by this shard or not, every map and the games of the whole competition.
+    // Each shard reads all of them for it, which costs a pass over the inputs but not their loading.
+    uint64_t games = CompetitionTasks(files.size(), std::vector<uint64_t>(maps.size(), 0), competitionPairing()).size();
+    shardHeader = "shard=" + params.at("shard") + " competition=" + competitionFingerprint(shardAlgorithmNames, maps, competitionPairing(), games);
+
+    size_t shardMaps = 0;
+    for (size_t k = 0; k < maps.size(); ++k)
+        shardMaps += shape.gamesInShard(k) > 0 ? 1 : 0;
+    std::cout << "Shard " << params.at("shard") << ": " << shape.size() << " games on " << shardMaps << " of " << maps.size()
+              << " maps with " << neededCount << " of " << files.size() << " algorithms\n";
+}
+
+// Play a single competition game; the board is reloaded only when the task is on a different map
+GameOutcome Simulator::playGameTask(AbstractGameManager &gm, const GameTask &task,
+                                   std::string &cachedMapFile, std::unique_ptr<GameBoard> &gameBoard) const
+{
+    auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    const std::string &mapFile = mapFiles.at(task.mapIndex);
+    auto mapName = fs::path(mapFile).stem().string();
+
+    TraceRecorder::Span gameSpan("game");
+    GameOutcome cached;
+    bool isCached = cachedOutcome(task, cached);
+    if (tracer)
+    {
+        gameSpan.setArgs(TraceRecorder::args({{"map", mapName},
+                                              {"player1", registrar.getAlgorithm(task.player1_idx).name()},
+                                              {"player2", registrar.getAlgorithm(task.player2_idx).name()},
+                                              {"task", std::to_string(task.taskId)},
+                                              {"cached", isCached ? "true" : "false"}}));
+    }
+    if (isCached)
+    {
+        return cached;
+    }
+    // The peak then covers this game alone, including the board if it is loaded below
+    if (measurePeakRss)
+        MemoryGate::resetPeakRss();
+
+    if (!gameBoard || cachedMapFile != mapFile)
+    {
+        gameBoard.reset();
+        gameBoard = createGameBoard(mapFile);
+        cachedMapFile = mapFile;
+    }
+
+    // Create players
+    std::unique_ptr<Player> p1, p2;
+    {
+        TraceRecorder::Span span("create players");
+        p1 = registrar.getAlgorithm(task.player1_idx).createPlayer(1, gameBoard->getWidth(), gameBoard->getHeight(), gameBoard->getMaxSteps(), 0);
+        p2 = registrar.getAlgorithm(task.player2_idx).createPlayer(2, gameBoard->getWidth(), gameBoard->getHeight(), gameBoard->getMaxSteps(), 0);
+    }
+    auto sat = SatelliteViewImpl(*gameBoard, Position(-1, -1));
+
+    auto start = std::chrono::steady_clock::now();
+    GameResult result;
+    {
+        TraceRecorder::Span span("gm.run");
+        TraceRecorder::StepSpans steps(tracer ? stepObserverOf(GameManagerRegistrar::getGameManagerRegistrar().getGM()[0].name) : nullptr);
+        result = gm.run(
+            gameBoard->getWidth(), gameBoard->getHeight(),
+            dynamic_cast<SatelliteView &>(sat), mapName,
+            gameBoard->getMaxSteps(), gameBoard->getNumShells(),
+            *p1, registrar.getAlgorithm(task.player1_idx).name(),
+            *p2, registrar.getAlgorithm(task.player2_idx).name(),
+            registrar.getAlgorithm(task.player1_idx).getTankAlgorithmFactory(),
+            registrar.getAlgorithm(task.player2_idx).getTankAlgorithmFactory());
+    }
+    GameOutcome outcome = makeOutcome(result, start);
+    if (measurePeakRss)
+        outcome.peakRssKb = MemoryGate::processStatusKb("VmHWM");
+    checkAgainstCache(task, outcome);
+    return outcome;
+}
+
+TraceRecorder::StepObserverSetter Simulator::stepObserverOf(const std::string &gameManager) const
+{
+    auto it = stepObservers.find(gameManager);
+    return it == stepObservers.end() ? nullptr : it->second;
+}
+
+GameOutcome Simulator::makeOutcome(const GameResult &result, std::chrono::steady_clock::time_point start)
+{
+    GameOutcome outcome;
+    outcome.winner = result.winner;
+    outcome.reason = result.reason;
+    outcome.rounds = result.rounds;
+    for (size_t i = 0; i < 2 && i < result.remaining_tanks.size(); ++i)
+    {
+        outcome.remainingTanks[i] = result.remaining_tanks[i];
+    }
+    outcome.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return outcome;
+}
+
+void Simulator::logGame(const GameTask &task, const std::string &player1, const std::string &player2, const GameOutcome &outcome)
+{
+    if (resultsLog)
+    {
+        resultsLog->record(fs::path(mapFiles[task.mapIndex]).stem().string(), player1, player2, outcome);
+    }
+    if (journal)
+    {
+        journal->record(task.taskId, outcome);
+    }
+
+    uint64_t key;
+    if (!cacheKey(task, key))
+    {
+        return;
+    }
+    switch (outcome.cacheUse)
+    {
+    case CacheUse::HIT:
+        cacheHits++;
+        return;
+    case CacheUse::VERIFIED:
+        cacheVerified++;
+        return;
+    case CacheUse::MISMATCH:
+    {
+        cacheMismatches++;
+        GameOutcome cached;
+        resultCache->find(key, cached);
+        std::cerr << "Result cache mismatch for " << player1 << " vs " << player2 << " on " << mapFiles[task.mapIndex]
+                  << ": cached winner " << cached.winner << " after " << cached.rounds << " rounds, replayed winner "
+                  << outcome.winner << " after " << outcome.rounds << " rounds\n";
+        break;
+    }
+    case CacheUse::NONE:
+        break;
+    }
+    resultCache->store(key, outcome);
+}
+
+// With result_cache=, hash every input a game depends on. Only games between two algorithms named in
+// deterministic= (or deterministic=all) are looked up and stored.
+void Simulator::openResultCache(const std::vector<std::string> &algorithmNames)
+{
+    if (!params.count("result_cache"))
+    {
+        return;
+    }
+
+    double verifyPercent = params.count("cache_verify") ? std::stod(params.at("cache_verify")) : 0;
+    resultCache = std::make_unique<ResultCache>(params.at("result_cache"), verifyPercent);
+    // Keys include the seating, and rotation seats most pairs differently once the number of algorithms changes
+    if (competitionPairing() == CompetitionTasks::Pairing::Rotation)
+    {
+        std::cerr << "result_cache: with rotation pairing, adding or removing an algorithm re-pairs most games, "
+                     "so few of them are found in the cache; round_robin=full keeps the pairs stable\n";
+    }
+
+    auto fileHash = [this](const std::string &path)
+    {
+        if (pluginCache)
+            return pluginCache->hashOf(path);
+        ContentHash hash;
+        if (!hash.addFile(path))
+            throw std::runtime_error("Cannot read " + path);
+        return hash.value();
+    };
+    gameManagerHash = fileHash(params.at("game_manager"));
+    algorithmHashes.clear();
+    for (const auto &name : algorithmNames)
+    {
+        algorithmHashes.push_back(fileHash((fs::path(params.at("algorithms_folder")) / (name + ".so")).string()));
+    }
+    mapHashes.clear();
+    for (const auto &map : mapFiles)
+    {
+        mapHashes.push_back(fileHash(map));
+    }
+
+    std::string declared = params.count("deterministic") ? params.at("deterministic") : "";
+    deterministicAlgorithms.assign(algorithmNames.size(), declared == "all");
+    std::istringstream names(declared == "all" ? "" : declared);
+    for (std::string name; std::getline(names, name, ',');)
+    {
+        auto it = std::find(algorithmNames.begin(), algorithmNames.end(), name);
+        if (it == algorithmNames.end())
+        {
+            std::cerr << "deterministic: no algorithm named " << name << "\n";
+            continue;
+        }
+        deterministicAlgorithms[it - algorithmNames.begin()] = 1;
+    }
+}
+
+// Cache key of the game: game manager, both algorithms in seating order and the map. False if the
+// game is not cacheable.
+bool Simulator::cacheKey(const GameTask &task, uint64_t &key) const
+{
+    if (!resultCache || !deterministicAlgorithms[task.player1_idx] || !deterministicAlgorithms[task.player2_idx])
+    {
+        return false;
+    }
+    uint64_t inputs[4] = {gameManagerHash, algorithmHashes[task.player1_idx], algorithmHashes[task.player2_idx], mapHashes[task.mapIndex]};
+    ContentHash hash;
+    hash.add(inputs, sizeof(inputs));
+    key = hash.value();
+    return true;
+}
+
+// The cached outcome of the game, unless it has none or was picked to be played again for cache_verify=
+bool Simulator::cachedOutcome(const GameTask &task, GameOutcome &out) const
+{
+    uint64_t key;
+    if (!cacheKey(task, key) || resultCache->sampledForVerification(key) || !resultCache->find(key, out))
+    {
+        return false;
+    }
+    out.cacheUse = CacheUse::HIT;
+    return true;
+}
+
+// Marks a played game that also has a cached outcome as VERIFIED or MISMATCH
+void Simulator::checkAgainstCache(const GameTask &task, GameOutcome &outcome) const
+{
+    uint64_t key;
+    GameOutcome cached;
+    if (!cacheKey(task, key) || !resultCache->find(key, cached))
+    {
+        return;
+    }
+    bool same = cached.winner == outcome.winner && cached.reason == outcome.reason && cached.rounds == outcome.rounds &&
+                cached.remainingTanks[0] == outcome.remainingTanks[0] && cached.remainingTanks[1] == outcome.remainingTanks[1];
+    outcome.cacheUse = same ? CacheUse::VERIFIED : CacheUse::MISMATCH;
+}
+
+// With progress=<sec> and/or metrics_file=<path>, create the metrics registry and a reporter publishing it
+// until the returned reporter is destroyed; without them metrics stay off and cost one branch per game
+std::unique_ptr<MetricsReporter> Simulator::startMetrics(size_t workers, uint64_t totalGames, std::function<uint64_t()> queueDepth, bool busyIsTotal)
+{
+    if (!params.count("progress") && !params.count("metrics_file"))
+    {
+        return nullptr;
+    }
+
+    double interval = params.count("progress") ? std::stod(params.at("progress")) : 5.0;
+    metrics = std::make_unique<MetricsRegistry>(workers);
+    return std::make_unique<MetricsReporter>(*metrics, totalGames, interval, params.count("progress") > 0,
+                                             params.count("metrics_file") ? params.at("metrics_file") : "",
+                                             std::move(queueDepth), busyIsTotal);
+}
+
+// Failed games (winner -1) are counted apart; a cache hit took no time
+void Simulator::recordMetrics(size_t worker, const GameOutcome &outcome)
+{
+    if (!metrics)
+    {
+        return;
+    }
+    if (outcome.winner < 0)
+        metrics->recordFailure(worker);
+    else
+        metrics->recordGame(worker, outcome.cacheUse == CacheUse::HIT ? 0 : outcome.durationMs);
+}
+
+std::vector<std::string> Simulator::registeredAlgorithmNames() const
+{
+    auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    std::vector<std::string> names;
+    for (size_t i = 0; i < registrar.count(); ++i)
+    {
+        names.push_back(registrar.getAlgorithm(i).name());
+    }
+    return names;
+}
+
+// The inputs of a competition with their file contents: the game manager, the algorithms in the given
+// order and the maps in map order, each of the latter with its name
+void Simulator::hashGameManager(ContentHash &hash) const
+{
+    hash.addFile(params.at("game_manager"));
+}
+
+void Simulator::hashAlgorithms(ContentHash &hash, const std::vector<std::string> &algorithmNames) const
+{
+    for (const auto &name : algorithmNames)
+    {
+        hash.addString(name);
+        hash.addFile((fs::path(params.at("algorithms_folder")) / (name + ".so")).string());
+    }
+}
+
+void Simulator::hashMaps(ContentHash &hash, const std::vector<std::string> &maps) const
+{
+    for (const auto &map : maps)
+    {
+        hash.addString(fs::path(map).filename().string());
+        hash.addFile(map);
+    }
+}
+
+// Fingerprint of everything that decides the games of a competition: its inputs, the number of games and the pairing
+std::string Simulator::competitionFingerprint(const std::vector<std::string> &algorithmNames, const std::vector<std::string> &maps,
+                                              CompetitionTasks::Pairing pairing, uint64_t games) const
+{
+    ContentHash hash;
+    hashGameManager(hash);
+    hashAlgorithms(hash, algorithmNames);
+    hashMaps(hash, maps);
+
+    uint64_t pairingId = static_cast<uint64_t>(pairing);
+    hash.add(&games, sizeof(games));
+    hash.add(&pairingId, sizeof(pairingId));
+    return hash.hex();
+}
+
+// What a worker and its coordinator compare before any game is handed out: "<gm> <algorithms> <maps>"
+std::string Simulator::inputHashes(const std::vector<std::string> &algorithmNames, const std::vector<std::string> &maps) const
+{
+    ContentHash gm, algorithms, mapContents;
+    hashGameManager(gm);
+    hashAlgorithms(algorithms, algorithmNames);
+    hashMaps(mapContents, maps);
+    return gm.hex() + " " + algorithms.hex() + " " + mapContents.hex();
+}
+
+// With journal=, open the journal and return the stats of the games it already holds;
+// those games are then skipped through alreadyPlayed(). The results log is written anew by every run,
+// so the journaled games are logged again first and the log still lists every game of the competition.
+std::vector<AlgorithmStats> Simulator::resumeFromJournal(const CompetitionTasks &tasks, const std::vector<std::string> &algorithmNames)
+{
+    std::vector<AlgorithmStats> stats(algorithmNames.size());
+    if (!params.count("journal"))
+    {
+        return stats;
+    }
+
+    journal = std::make_unique<CompetitionJournal>(params.at("journal"), competitionFingerprint(algorithmNames, mapFiles, tasks.getPairing(), tasks.size()));
+    const auto &completed = journal->getCompleted();
+    if (completed.empty())
+    {
+        return stats;
+    }
+
+    for (const auto &[taskId, outcome] : completed)
+    {
+        if (taskId >= tasks.idRange().begin && taskId < tasks.idRange().end)
+        {
+            GameTask task = tasks.byId(taskId);
+            addGameResult(stats, task, outcome.winner, outcome.rounds);
+            if (resultsLog)
+                resultsLog->record(fs::path(mapFiles[task.mapIndex]).stem().string(), algorithmNames[task.player1_idx],
+                                   algorithmNames[task.player2_idx], outcome);
+        }
+    }
+    std::cout << "Resuming from journal: " << completed.size() << " of " << tasks.size() << " games already played.\n";
+    return stats;
+}
+
+bool Simulator::alreadyPlayed(const GameTask &task) const
+{
+    return journal && journal->getCompleted().count(task.taskId);
+}
+
+size_t Simulator::journaledGames() const
+{
+    return journal ? journal->getCompleted().size() : 0;
+}
+
+// Tie gives both players 1 point, a win gives the winner 3
+void Simulator::addGameResult(std::vector<AlgorithmStats> &stats, const GameTask &task, int winner, size_t rounds)
+{
+    auto &first = stats[task.player1_idx];
+    auto &second = stats[task.player2_idx];
+    first.rounds += rounds;
+    second.rounds += rounds;
+    if (winner == 0)
+    {
+        first.score += 1;
+        second.score += 1;
+        first.ties++;
+        second.ties++;
+    }
+    else
+    {
+        auto &won = winner == 1 ? first : second;
+        auto &lost = winner == 1 ? second : first;
+        won.score += 3;
+        won.wins++;
+        lost.losses++;
+    }
+}
+
+// Competition task structure
+void Simulator::runCompetitionThreaded(bool verbose)
+{
+    auto &gmRegistrar = GameManagerRegistrar::getGameManagerRegistrar();
+    (void)gmRegistrar;
+    auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+
+    // Load shared objects
+    loadCompetitionAlgorithms();
+    loadSharedObjectFromFile(params.at("game_manager"), SharedObjectType::GameManager);
+    std::cout << registrar.count() << " algorithms registered.\n";
+    if (registrar.count() < 2 && shardCount <= 1)
+    {
+        throw std::runtime_error("At least two algorithms are required for competition mode.");
+    }
+
+    std::string mapFolder = params.at("game_maps_folder");
     std::string gmSO = params.at("game_manager");
     std::string algFolder = params.at("algorithms_folder");
 
     std::string timeStr = getTimeString();
     std::string outputFile = algFolder + "/competition_" + timeStr + ".txt";
-    std::ofstream out(outputFile);
-    if (!out)
+
+    std::vector<std::string> maps = sortedDirectoryFiles(mapFolder, "");
+
+    size_t N = registrar.count();
+    CompetitionTasks tasks = makeCompetitionTasks(maps, N);
+    std::vector<AlgorithmStats> resumed = resumeFromJournal(tasks, registeredAlgorithmNames());
+    openResultCache(registeredAlgorithmNames());
+
+    uint64_t totalTasks = tasks.size() - journaledGames();
+    int actualThreads = getOptimalThreadCount(static_cast<size_t>(std::min<uint64_t>(totalTasks, INT32_MAX)));
+
+    WorkStealingScheduler<TaskRange> scheduler(actualThreads);
+    distributeTasks(tasks, scheduler);
+    openMemoryGate(memoryState, actualThreads);
+    auto reporter = startMetrics(actualThreads, totalTasks, [&scheduler]
+                                 {
+                                     uint64_t queued = 0;
+                                     scheduler.forEach([&queued](const TaskRange &range)
+                                                       { queued += range.end - range.begin; });
+                                     return queued; });
+
+    // Every worker tallies into its own slot; the slots are merged once all games are done
+    std::vector<std::vector<AlgorithmStats>> workerStats(actualThreads, std::vector<AlgorithmStats>(N));
+    if (actualThreads == 1)
+    {
+        // Too few games left for more threads; play them here, the plugins are already loaded
+        competitionWorker(scheduler, 0, tasks, workerStats[0], verbose);
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        for (int i = 0; i < actualThreads; ++i)
+        {
+            workers.emplace_back(&Simulator::competitionWorker, this,
+                                 std::ref(scheduler), static_cast<size_t>(i), std::cref(tasks),
+                                 std::ref(workerStats[i]), verbose);
+        }
+
+        // Wait for all threads to complete
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    std::map<std::string, int> scores;
+    for (size_t i = 0; i < N; ++i)
+    {
+        scores[registrar.getAlgorithm(i).name()] = resumed[i].score;
+    }
+    for (const auto &stats : workerStats)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            scores[registrar.getAlgorithm(i).name()] += stats[i].score;
+        }
+    }
+    for (const auto &name : shardAlgorithmNames)
+    {
+        scores.try_emplace(name, 0);
+    }
+
+    std::ofstream out;
+    openResultFile(out, outputFile);
+    writeCompetitionResults(out, mapFolder, gmSO, shardHeader, scores);
+}
+
+void Simulator::competitionWorker(
+    WorkStealingScheduler<TaskRange> &scheduler,
+    size_t workerIndex,
+    const CompetitionTasks &tasks,
+    std::vector<AlgorithmStats> &stats,
+    bool verbose)
+{
+    auto &gmRegistrar = GameManagerRegistrar::getGameManagerRegistrar();
+    auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+
+    // Each thread creates its own GameManager instance
+    const auto &gmList = gmRegistrar.getGM();
+    if (gmList.empty())
+    {
+        throw std::runtime_error("GameManager list is empty. Cannot retrieve factory.");
+    }
+    auto gmFactory = gmRegistrar.getGM()[0].getFactory();
+    auto gm = gmFactory(verbose);
+
+    if (tracer)
+        tracer->attachThread("worker " + std::to_string(workerIndex));
+
+    // Games of one map are scheduled on the same worker, so the last parsed board is usually reusable
+    std::string cachedMapFile;
+    std::unique_ptr<GameBoard> threadBoard;
+    MemoryGate::Holder memory;
+
+    TaskRange range;
+    while (scheduler.pop(workerIndex, range))
+    {
+        // Take one game and put the rest of the range back, so idle workers can still steal from a map
+        // that is in progress; the next pop usually continues the same range and reuses the board
+        if (range.end - range.begin > 1)
+        {
+            scheduler.pushFront(workerIndex, {range.begin + 1, range.end});
+            range.end = range.begin + 1;
+        }
+
+        for (uint64_t position = range.begin; position < range.end; ++position)
+        {
+            GameTask task = tasks.at(position);
+            if (alreadyPlayed(task))
+                continue;
+            try
+            {
+                GameOutcome outcome;
+                {
+                    MemoryGate::Admission admission(*memoryGate, memory, mapMemory[task.mapIndex]);
+                    if (metrics)
+                        metrics->gameStarted(workerIndex);
+                    outcome = playGameTask(*gm, task, cachedMapFile, threadBoard);
+                }
+
+                // Update this worker's stats and metrics shard, no locking needed
+                addGameResult(stats, task, outcome.winner, outcome.rounds);
+                recordMetrics(workerIndex, outcome);
+                logGame(task, registrar.getAlgorithm(task.player1_idx).name(), registrar.getAlgorithm(task.player2_idx).name(), outcome);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Error in worker thread for task " << task.taskId
+                          << ": " << e.what() << std::endl;
+                recordMetrics(workerIndex, GameOutcome());
+            }
+        }
+    }
+}
+
+void Simulator::runCompetitionProcesses(bool verbose)
+{
+    auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+
+    loadCompetitionAlgorithms();
+    loadSharedObjectFromFile(params.at("game_manager"), SharedObjectType::GameManager);
+    std::cout << registrar.count() << " algorithms registered.\n";
+    if (registrar.count() < 2 && shardCount <= 1)
+    {
+        throw std::runtime_error("At least two algorithms are required for competition mode.");
+    }
+    if (GameManagerRegistrar::getGameManagerRegistrar().getGM().empty())
+    {
+        throw std::runtime_error("GameManager list is empty. Cannot retrieve factory.");
+    }
+
+    std::string mapFolder = params.at("game_maps_folder");
+    std::string gmSO = params.at("game_manager");
+    std::string algFolder = params.at("algorithms_folder");
+
+    std::string timeStr = getTimeString();
+    std::string outputFile = algFolder + "/competition_" + timeStr + ".txt";
+
+    std::vector<std::string> maps = sortedDirectoryFiles(mapFolder, "");
+
+    // Workers claim positions in scheduling order: longest maps first, games of a map next to each other
+    CompetitionTasks tasks = makeCompetitionTasks(maps, registrar.count());
+    std::vector<AlgorithmStats> stats = resumeFromJournal(tasks, registeredAlgorithmNames());
+    openResultCache(registeredAlgorithmNames());
+    uint64_t toPlay = tasks.size() - journaledGames();
+
+    size_t N = registrar.count();
+    size_t workerCount = std::max<size_t>(1, std::min<uint64_t>(numProcesses, toPlay));
+    SharedTaskArea area(workerCount);
+    openMemoryGate(area.memoryState(), workerCount);
+
+    auto reporter = startMetrics(workerCount, toPlay, [&area, &tasks]
+                                 { return tasks.size() - std::min<uint64_t>(area.claimedCount(), tasks.size()); });
+
+    std::cout.flush();
+    std::cerr.flush();
+    std::vector<pid_t> pids(workerCount, -1);
+    for (size_t w = 0; w < workerCount; ++w)
+    {
+        pids[w] = spawnProcessWorker(area, w, tasks, verbose);
+    }
+
+    // A worker claims positions in increasing order, so its last reported position tells whether
+    // the game it was in when it died had already been reported
+    std::vector<int64_t> lastReported(workerCount, -1);
+    uint64_t reportedGames = 0;
+    size_t failedGames = 0;
+
+    auto drain = [&](size_t w)
+    {
+        bool any = false;
+        ProcessGameResult r;
+        while (area.pop(w, r))
+        {
+            any = true;
+            if (r.position >= tasks.size())
+                continue;
+            lastReported[w] = static_cast<int64_t>(r.position);
+            reportedGames++;
+            recordMetrics(w, r.outcome);
+            if (r.outcome.winner < 0)
+            {
+                failedGames++;
+                continue;
+            }
+            GameTask task = tasks.at(r.position);
+            addGameResult(stats, task, r.outcome.winner, r.outcome.rounds);
+            logGame(task, registrar.getAlgorithm(task.player1_idx).name(), registrar.getAlgorithm(task.player2_idx).name(), r.outcome);
+        }
+        return any;
+    };
+
+    size_t alive = workerCount;
+    while (alive > 0)
+    {
+        bool progress = false;
+        for (size_t w = 0; w < workerCount; ++w)
+        {
+            progress |= drain(w);
+        }
+
+        int status = 0;
+        pid_t pid;
+        while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+        {
+            progress = true;
+            auto slot = std::find(pids.begin(), pids.end(), pid);
+            if (slot == pids.end())
+                continue;
+            size_t w = slot - pids.begin();
+            pids[w] = -1;
+            alive--;
+
+            // Results the worker pushed before exiting are still in its ring
+            drain(w);
+            auto &channel = area.channel(w);
+            int64_t current = channel.currentTask.exchange(-1);
+            memoryGate->release(channel.memory);
+            bool crashed = !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+            if (!crashed)
+                continue;
+
+            if (WIFSIGNALED(status))
+                std::cerr << "Worker process " << pid << " was killed by signal " << WTERMSIG(status);
+            else
+                std::cerr << "Worker process " << pid << " exited with status " << WEXITSTATUS(status);
+
+            if (current < 0 || current == lastReported[w])
+            {
+                std::cerr << " outside of a game\n";
+                continue;
+            }
+            GameTask task = tasks.at(current);
+            std::cerr << " while playing " << registrar.getAlgorithm(task.player1_idx).name()
+                      << " vs " << registrar.getAlgorithm(task.player2_idx).name()
+                      << " on " << mapFiles[task.mapIndex] << "; the game is not scored\n";
+            reportedGames++;
+            failedGames++;
+            recordMetrics(w, GameOutcome());
+
+            // Only a worker that died inside a game is replaced, so a worker that cannot even start is not respawned forever
+            if (!area.allClaimed(tasks.size()))
+            {
+                pids[w] = spawnProcessWorker(area, w, tasks, verbose);
+                alive++;
+            }
+        }
+
+        if (!progress)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+
+    uint64_t unplayed = toPlay - reportedGames;
+    if (failedGames + unplayed > 0)
+    {
+        std::cerr << failedGames << " games failed and " << unplayed << " were not played.\n";
+    }
+
+    std::map<std::string, int> scores;
+    for (size_t i = 0; i < N; ++i)
+    {
+        scores[registrar.getAlgorithm(i).name()] += stats[i].score;
+    }
+    for (const auto &name : shardAlgorithmNames)
+    {
+        scores.try_emplace(name, 0);
+    }
+
+    std::ofstream out;
+    openResultFile(out, outputFile);
+    writeCompetitionResults(out, mapFolder, gmSO, shardHeader, scores);
+}
+
+// Fork a worker for slot w; the child never returns from here
+pid_t Simulator::spawnProcessWorker(SharedTaskArea &area, size_t w, const CompetitionTasks &tasks, bool verbose)
+{
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        throw std::runtime_error(std::string("Failed to fork worker process: ") + std::strerror(errno));
+    }
+    if (pid > 0)
+    {
+        return pid;
+    }
+
+    int exitCode = 0;
+    try
+    {
+        // A worker should not outlive the tournament it plays for
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        applyProcessLimits();
+        processWorker(area, w, tasks, verbose);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Worker process " << getpid() << ": " << e.what() << std::endl;
+        exitCode = 1;
+    }
+    // The parent merges it into the trace file; a worker that crashes takes its spans with it
+    if (tracer)
+        tracer->writePart();
+    std::cout.flush();
+    std::cerr.flush();
+    // Skip static destructors and atexit handlers; they belong to the parent
+    _exit(exitCode);
+}
+
+// Optional per-worker memory rlimit from process_memory_mb=; process_cpu_sec= is armed per game by armGameCpuLimit()
+void Simulator::applyProcessLimits() const
+{
+    if (params.count("process_memory_mb"))
+    {
+        rlim_t bytes = static_cast<rlim_t>(std::stoull(params.at("process_memory_mb"))) << 20;
+        struct rlimit limit = {bytes, bytes};
+        if (setrlimit(RLIMIT_AS, &limit) != 0)
+            throw std::runtime_error(std::string("Failed to set process_memory_mb: ") + std::strerror(errno));
+    }
+}
+
+// process_cpu_sec= is a budget per game. RLIMIT_CPU counts the whole life of the worker, so before every game
+// the soft limit is moved to the CPU time used so far (rounded up to a second) plus the budget. Only the soft
+// limit moves, since a lowered hard limit could not be raised again; going over it ends the worker with SIGXCPU.
+void Simulator::armGameCpuLimit() const
+{
+    if (!params.count("process_cpu_sec"))
+        return;
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        throw std::runtime_error(std::string("Failed to read CPU time: ") + std::strerror(errno));
+    uint64_t usedUs = (static_cast<uint64_t>(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000 +
+                      usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_CPU, &limit) != 0)
+        throw std::runtime_error(std::string("Failed to read process_cpu_sec limit: ") + std::strerror(errno));
+    limit.rlim_cur = static_cast<rlim_t>((usedUs + 999999) / 1000000 + std::stoull(params.at("process_cpu_sec")));
+    if (limit.rlim_max != RLIM_INFINITY)
+        limit.rlim_cur = std::min(limit.rlim_cur, limit.rlim_max);
+    if (setrlimit(RLIMIT_CPU, &limit) != 0)
+        throw std::runtime_error(std::string("Failed to set process_cpu_sec: ") + std::strerror(errno));
+}
+
+// Body of a worker process: claim tasks until none are left and push every result into the worker's ring
+void Simulator::processWorker(SharedTaskArea &area, size_t w, const CompetitionTasks &tasks, bool verbose)
+{
+    auto gmFactory = GameManagerRegistrar::getGameManagerRegistrar().getGM()[0].getFactory();
+    auto gm = gmFactory(verbose);
+
+    std::string cachedMapFile;
+    std::unique_ptr<GameBoard> workerBoard;
+    auto &channel = area.channel(w);
+    measurePeakRss = true;
+    if (tracer)
+    {
+        tracer->setProcessName("worker process " + std::to_string(w));
+        tracer->attachThread("worker " + std::to_string(w));
+    }
+
+    int64_t position;
+    while ((position = area.claimTask(tasks.size())) >= 0)
+    {
+        GameTask task = tasks.at(position);
+        if (alreadyPlayed(task))
+            continue;
+        channel.currentTask.store(position);
+        ProcessGameResult r{static_cast<uint64_t>(position), GameOutcome()};
+        armGameCpuLimit();
+        try
+        {
+            MemoryGate::Admission admission(*memoryGate, channel.memory, mapMemory[task.mapIndex]);
+            uint64_t startKb = MemoryGate::processStatusKb("VmRSS");
+            r.outcome = playGameTask(*gm, task, cachedMapFile, workerBoard);
+            // What the game actually took raises the estimate for this worker's later games on the map
+            if (r.outcome.peakRssKb > startKb)
+                mapMemory[task.mapIndex] = std::max(mapMemory[task.mapIndex], (r.outcome.peakRssKb - startKb) << 10);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in worker process for task " << task.taskId
+                      << ": " << e.what() << std::endl;
+        }
+        area.push(w, r);
+        channel.currentTask.store(-1);
+    }
+}
+
+// A lost connection puts a game back in the queue at most this many times before it counts as failed
+static constexpr int MAX_GAME_ATTEMPTS = 3;
+
+// Hand out competition games to -worker instances over TCP and merge their results. Maps and
+// algorithms are taken in sorted order, so the output does not depend on which worker played what.
+// Games of a worker that disconnects, or reports nothing for batch_timeout_sec, are given to the next
+// free worker. Workers whose input files hash differently from ours are turned away.
+void Simulator::runCoordinator()
+{
+    std::string mapFolder = params.at("game_maps_folder");
+    std::string gmSO = params.at("game_manager");
+    std::string algFolder = params.at("algorithms_folder");
+
+    std::vector<std::string> maps = sortedDirectoryFiles(mapFolder, "");
+    std::vector<std::string> names;
+    for (const auto &file : sortedDirectoryFiles(algFolder, ".so"))
+    {
+        names.push_back(fs::path(file).stem().string());
+    }
+    if (names.size() < 2)
+    {
+        throw std::runtime_error("At least two algorithms are required for competition mode.");
+    }
+
+    size_t batchSize = 8;
+    int port = 0;
+    long batchTimeoutSec = 600;
+    try
     {
-        std::cerr << "Cannot create output file: " << outputFile << ", printing to screen.\n";
-        out.basic_ios<char>::rdbuf(std::cout.rdbuf());
+        if (params.count("batch_size"))
+            batchSize = std::stoul(params.at("batch_size"));
+        if (params.count("batch_timeout_sec"))
+            batchTimeoutSec = std::stol(params.at("batch_timeout_sec"));
+        port = std::stoi(params.at("port"));
+    }
+    catch (const std::exception &)
+    {
+        throw std::invalid_argument("Invalid port, batch_size or batch_timeout_sec value");
     }
+    if (batchSize == 0 || batchTimeoutSec <= 0 || port <= 0 || port > 65535)
+    {
+        throw std::invalid_argument("Invalid port, batch_size or batch_timeout_sec value");
+    }
+    auto batchTimeout = std::chrono::seconds(batchTimeoutSec);
 
-    out << "game_maps_folder=" << mapFolder << "\n";
-    out << "game_manager=" << gmSO << "\n\n";
+    CompetitionTasks tasks = makeCompetitionTasks(maps, names.size());
+    std::vector<AlgorithmStats> stats = resumeFromJournal(tasks, names);
+    openResultCache(names);
+    uint64_t remaining = tasks.size() - journaledGames();
+    std::string hashes = inputHashes(names, maps);
+    int listenFd = LineSocket::listenOn(static_cast<uint16_t>(port));
+    std::cout << "Coordinator listening on port " << port << ", " << remaining << " games to play.\n";
 
-    // Initialize scores
-    std::map<std::string, int> scores;
-    for (size_t i = 0; i < registrar.count(); ++i)
+    struct WorkerConnection
     {
-        scores[registrar.getAlgorithm(i).name()] = 0;
+        LineSocket socket;
+        std::vector<uint64_t> inFlight;
+        bool greeted = false; // its HELLO matched our input hashes
+        bool idle = false;
+        bool lost = false;
+        std::chrono::steady_clock::time_point deadline; // for the next result while games are in flight
+    };
+    std::vector<std::unique_ptr<WorkerConnection>> connections;
+
+    // Games still to hand out, as ranges of positions; a lost game comes back as a range of its own
+    std::deque<TaskRange> pending;
+    for (size_t i = 0; i < tasks.mapCount(); ++i)
+    {
+        if (tasks.mapRange(i).begin != tasks.mapRange(i).end)
+            pending.push_back(tasks.mapRange(i));
     }
+    std::map<uint64_t, int> attempts; // only games that were lost at least once
+    size_t failedGames = 0;
+
+    auto describe = [&](uint64_t position)
+    {
+        GameTask task = tasks.at(position);
+        return names[task.player1_idx] + " vs " + names[task.player2_idx] + " on " + mapFiles[task.mapIndex];
+    };
+
+    // Remote workers share one metrics shard, so the reporter shows how many of them were busy
+    std::atomic<uint64_t> queued{tasks.size()};
+    auto reporter = startMetrics(1, remaining, [&queued]
+                                 { return queued.load(); }, true);
 
-    // Get all map files
-    std::vector<std::string> maps;
-    for (auto &p : std::filesystem::directory_iterator(mapFolder))
+    auto finishGame = [&](uint64_t position, GameOutcome outcome)
     {
-        maps.push_back(p.path().string());
+        GameTask task = tasks.at(position);
+        remaining--;
+        recordMetrics(0, outcome);
+        if (outcome.winner < 0)
+        {
+            std::cerr << "Game " << describe(position) << " could not be played by a worker and is not scored\n";
+            failedGames++;
+            return;
+        }
+        if (outcome.cacheUse == CacheUse::NONE)
+            checkAgainstCache(task, outcome);
+        addGameResult(stats, task, outcome.winner, outcome.rounds);
+        logGame(task, names[task.player1_idx], names[task.player2_idx], outcome);
+    };
+
+    // Games with a cached outcome are settled here, before any worker has to connect
+    GameOutcome cached;
+    for (uint64_t position = 0; resultCache && position < tasks.size(); ++position)
+    {
+        GameTask task = tasks.at(position);
+        if (!alreadyPlayed(task) && cachedOutcome(task, cached))
+            finishGame(position, cached);
     }
 
-    // Create task queue
-    std::queue<GameTask> taskQueue;
-    std::mutex queueMutex;
-    size_t taskId = 0;
+    auto takePosition = [&](uint64_t &position)
+    {
+        while (!pending.empty())
+        {
+            position = pending.front().begin++;
+            if (pending.front().begin == pending.front().end)
+                pending.pop_front();
+            GameTask task = tasks.at(position);
+            if (!alreadyPlayed(task) && !cachedOutcome(task, cached))
+                return true;
+        }
+        return false;
+    };
 
-    size_t N = registrar.count();
-    for (size_t k = 0; k < maps.size(); ++k)
+    auto sendBatch = [&](WorkerConnection &connection)
     {
-        std::set<std::pair<size_t, size_t>> playedPairs;
+        // A game that was already lost once goes out alone, so it cannot take a batch of healthy games down with it
+        size_t limit = !pending.empty() && attempts.count(pending.front().begin) ? 1 : batchSize;
+        std::vector<uint64_t> batch;
+        uint64_t position;
+        while (batch.size() < limit && takePosition(position))
+        {
+            batch.push_back(position);
+        }
+        connection.idle = batch.empty();
+        if (connection.idle)
+            return;
 
-        for (size_t i = 0; i < N; ++i)
+        connection.deadline = std::chrono::steady_clock::now() + batchTimeout;
+        bool ok = connection.socket.sendLine("TASKS " + std::to_string(batch.size()));
+        for (uint64_t position : batch)
+        {
+            connection.inFlight.push_back(position);
+            GameTask task = tasks.at(position);
+            ok = ok && connection.socket.sendLine(std::to_string(position) + "\t" + fs::path(mapFiles[task.mapIndex]).filename().string() +
+                                                  "\t" + names[task.player1_idx] + "\t" + names[task.player2_idx]);
+        }
+        connection.lost = !ok;
+    };
+
+    // A worker first sends HELLO with the hashes of its game manager, algorithms and maps, and is answered
+    // WELCOME if they match ours, or ERROR and the connection is closed
+    auto greet = [&](WorkerConnection &connection, const std::string &line)
+    {
+        std::istringstream theirs(line.substr(6)), ours(hashes);
+        std::string mismatch;
+        for (const char *input : {"game manager", "algorithms", "maps"})
+        {
+            std::string their, our;
+            theirs >> their;
+            ours >> our;
+            if (their != our)
+                mismatch += std::string(mismatch.empty() ? "" : ", ") + input;
+        }
+        if (!mismatch.empty())
+        {
+            std::cerr << "Worker rejected, its " << mismatch << " differ from the coordinator's\n";
+            connection.socket.sendLine("ERROR " + mismatch + " differ from the coordinator's");
+            connection.lost = true;
+            return;
+        }
+        connection.greeted = connection.socket.sendLine("WELCOME");
+        connection.lost = !connection.greeted;
+    };
+
+    auto handleLine = [&](WorkerConnection &connection, const std::string &line)
+    {
+        if (!connection.greeted)
+        {
+            if (line.rfind("HELLO ", 0) == 0)
+            {
+                greet(connection, line);
+                return;
+            }
+            std::cerr << "Unexpected message from worker: " << line << "\n";
+            connection.lost = true;
+            return;
+        }
+        if (line == "READY")
+        {
+            sendBatch(connection);
+            return;
+        }
+
+        std::istringstream in(line);
+        std::string keyword;
+        uint64_t position = 0;
+        GameOutcome outcome;
+        if (!(in >> keyword >> position) || !decodeOutcome(in, outcome) ||
+            keyword != "RESULT" || position >= tasks.size())
+        {
+            std::cerr << "Unexpected message from worker: " << line << "\n";
+            connection.lost = true;
+            return;
+        }
+
+        // Every game is in flight on exactly one connection, so anything else is a repeated report
+        auto it = std::find(connection.inFlight.begin(), connection.inFlight.end(), position);
+        if (it == connection.inFlight.end())
+            return;
+        connection.inFlight.erase(it);
+        connection.deadline = std::chrono::steady_clock::now() + batchTimeout;
+        attempts.erase(position);
+        finishGame(position, outcome);
+    };
+
+    // Unreported games of a lost worker go back to the front of the queue
+    auto requeue = [&](WorkerConnection &connection)
+    {
+        for (auto it = connection.inFlight.rbegin(); it != connection.inFlight.rend(); ++it)
         {
-            size_t j = (i + 1 + k % (N - 1)) % N;
-            if (i == j)
+            if (++attempts[*it] < MAX_GAME_ATTEMPTS)
+            {
+                pending.push_front({*it, *it + 1});
                 continue;
+            }
+            std::cerr << "Game " << describe(*it) << " was lost with " << MAX_GAME_ATTEMPTS << " workers and is not scored\n";
+            attempts.erase(*it);
+            remaining--;
+            failedGames++;
+            recordMetrics(0, GameOutcome());
+        }
+        if (!connection.inFlight.empty())
+            std::cerr << "Worker connection lost, " << connection.inFlight.size() << " games requeued\n";
+        connection.inFlight.clear();
+    };
 
-            auto pair = std::minmax(i, j);
-            if (playedPairs.count(pair))
+    while (remaining > 0)
+    {
+        std::vector<pollfd> fds;
+        fds.push_back({listenFd, POLLIN, 0});
+        for (const auto &connection : connections)
+        {
+            fds.push_back({connection->socket.getFd(), POLLIN, 0});
+        }
+        if (poll(fds.data(), fds.size(), 1000) < 0 && errno != EINTR)
+        {
+            ::close(listenFd);
+            throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+        }
+
+        for (size_t i = 0; i < connections.size(); ++i)
+        {
+            auto &connection = *connections[i];
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            if (!connection.socket.receive())
+            {
+                connection.lost = true;
                 continue;
+            }
+            std::string line;
+            while (!connection.lost && connection.socket.nextLine(line))
+            {
+                handleLine(connection, line);
+            }
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd >= 0)
+            {
+                int yes = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+                setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &yes, sizeof(yes));
+                connections.push_back(std::make_unique<WorkerConnection>());
+                connections.back()->socket = LineSocket(fd);
+            }
+        }
 
-            taskQueue.push({i, j, maps[k], taskId++});
-            playedPairs.insert(pair);
+        // A worker that stays connected but stops reporting would otherwise hold its batch until TCP keepalive gives up
+        auto now = std::chrono::steady_clock::now();
+        for (auto &connection : connections)
+        {
+            if (!connection->lost && !connection->inFlight.empty() && now > connection->deadline)
+            {
+                std::cerr << "Worker sent no result for " << batchTimeoutSec << " s\n";
+                connection->lost = true;
+            }
+            if (connection->lost)
+                requeue(*connection);
         }
-    }
+        connections.erase(std::remove_if(connections.begin(), connections.end(), [](const auto &connection)
+                                         { return connection->lost; }),
+                          connections.end());
 
-    size_t totalTasks = taskQueue.size();
-    int actualThreads = getOptimalThreadCount(totalTasks);
+        // Requeued games go to workers that were left waiting
+        for (auto &connection : connections)
+        {
+            if (connection->idle && !pending.empty())
+                sendBatch(*connection);
+        }
 
-    if (actualThreads == 1)
-    {
-        runCompetition(verbose);
-        return;
+        if (metrics)
+        {
+            uint64_t games = 0;
+            for (const auto &range : pending)
+                games += range.end - range.begin;
+            queued.store(games);
+        }
     }
-    std::vector<std::thread> workers;
-    for (int i = 0; i < actualThreads; ++i)
+
+    for (auto &connection : connections)
     {
-        workers.emplace_back(&Simulator::competitionWorker, this,
-                             std::cref(maps), std::ref(taskQueue),
-                             std::ref(queueMutex), std::ref(scores), verbose);
+        connection->socket.sendLine("DONE");
     }
+    connections.clear();
+    ::close(listenFd);
 
-    // Wait for all threads to complete
-    for (auto &worker : workers)
+    if (failedGames > 0)
     {
-        worker.join();
+        std::cerr << failedGames << " games failed.\n";
     }
 
-    // Write results
-    std::vector<std::pair<std::string, int>> scoreVec(scores.begin(), scores.end());
-    std::sort(scoreVec.begin(), scoreVec.end(), [](const auto &a, const auto &b)
-              { return b.second < a.second; });
-
-    for (const auto &[name, score] : scoreVec)
+    std::map<std::string, int> scores;
+    for (size_t i = 0; i < names.size(); ++i)
     {
-        out << name << " " << score << "\n";
+        scores[names[i]] += stats[i].score;
     }
 
-    out.close();
+    std::ofstream out;
+    openResultFile(out, algFolder + "/competition_" + getTimeString() + ".txt");
+    writeCompetitionResults(out, mapFolder, gmSO, shardHeader, scores);
 }
 
-void Simulator::competitionWorker(
-    const std::vector<std::string> &maps,
-    std::queue<GameTask> &taskQueue,
-    std::mutex &queueMutex,
-    std::map<std::string, int> &scores,
-    bool verbose)
+// Play the games a coordinator sends until it has none left. Maps and algorithms are looked up by
+// name in this worker's own folders, so those must hold the same files as on the coordinator, which
+// checks their hashes before sending any game.
+void Simulator::runWorker(bool verbose)
 {
-    (void)maps;
-    auto &gmRegistrar = GameManagerRegistrar::getGameManagerRegistrar();
     auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    loadSharedObjectsFromDirectory(params.at("algorithms_folder"), SharedObjectType::Algorithm);
+    loadSharedObjectFromFile(params.at("game_manager"), SharedObjectType::GameManager);
 
-    // Each thread creates its own GameManager instance
-    const auto &gmList = gmRegistrar.getGM();
-    if (gmList.empty())
+    auto &gmRegistrar = GameManagerRegistrar::getGameManagerRegistrar();
+    if (gmRegistrar.getGM().empty())
     {
         throw std::runtime_error("GameManager list is empty. Cannot retrieve factory.");
     }
     auto gmFactory = gmRegistrar.getGM()[0].getFactory();
     auto gm = gmFactory(verbose);
 
-    while (true)
+    std::map<std::string, size_t> indexByName;
+    for (size_t i = 0; i < registrar.count(); ++i)
+    {
+        indexByName[registrar.getAlgorithm(i).name()] = i;
+    }
+
+    std::string address = params.at("coordinator");
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos)
     {
-        GameTask task;
+        throw std::invalid_argument("coordinator must be given as host:port");
+    }
 
-        // Get next task from queue
+    // Workers may be started before the coordinator, so keep trying for a while
+    LineSocket socket;
+    for (int attempt = 0; !socket.isOpen(); ++attempt)
+    {
+        try
         {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            if (taskQueue.empty())
-            {
-                break; // No more tasks
-            }
-            task = taskQueue.front();
-            taskQueue.pop();
+            socket = LineSocket::connectTo(address.substr(0, colon), address.substr(colon + 1));
+        }
+        catch (const std::exception &)
+        {
+            if (attempt >= 60)
+                throw;
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
         }
+    }
 
-        try
+    std::string mapFolder = params.at("game_maps_folder");
+    std::map<std::string, size_t> mapIndexByName;
+    std::string cachedMapFile;
+    std::unique_ptr<GameBoard> workerBoard;
+    size_t played = 0;
+
+    // The coordinator compares these with the hashes of its own files before handing out any game
+    std::vector<std::string> names;
+    for (const auto &file : sortedDirectoryFiles(params.at("algorithms_folder"), ".so"))
+    {
+        names.push_back(fs::path(file).stem().string());
+    }
+    std::string line;
+    if (!socket.sendLine("HELLO " + inputHashes(names, sortedDirectoryFiles(mapFolder, ""))) || !socket.readLine(line))
+    {
+        throw std::runtime_error("Lost connection to coordinator");
+    }
+    if (line.rfind("ERROR ", 0) == 0)
+    {
+        throw std::runtime_error("Coordinator rejected this worker: " + line.substr(6));
+    }
+    if (line != "WELCOME")
+    {
+        throw std::runtime_error("Unexpected message from coordinator: " + line);
+    }
+
+    while (socket.sendLine("READY") && socket.readLine(line) && line != "DONE")
+    {
+        if (line.rfind("TASKS ", 0) != 0)
         {
-            // Load board for this thread
-            auto threadBoard = createGameBoard(task.mapFile);
+            throw std::runtime_error("Unexpected message from coordinator: " + line);
+        }
 
-            // Create players
-            auto p1 = registrar.getAlgorithm(task.player1_idx).createPlayer(1, threadBoard->getWidth(), threadBoard->getHeight(), threadBoard->getMaxSteps(), 0);
-            auto p2 = registrar.getAlgorithm(task.player2_idx).createPlayer(2, threadBoard->getWidth(), threadBoard->getHeight(), threadBoard->getMaxSteps(), 0);
-            auto sat = UserCommon_318885712_208230862::SatelliteViewImpl(*threadBoard, Position(-1, -1));
-            auto mapName = fs::path(task.mapFile).stem().string();
+        size_t count = std::stoul(line.substr(6));
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!socket.readLine(line))
+            {
+                throw std::runtime_error("Coordinator closed the connection in the middle of a batch");
+            }
 
-            GameResult result = gm->run(
-                threadBoard->getWidth(), threadBoard->getHeight(),
-                dynamic_cast<SatelliteView &>(sat), mapName,
-                threadBoard->getMaxSteps(), threadBoard->getNumShells(),
-                *p1, registrar.getAlgorithm(task.player1_idx).name(),
-                *p2, registrar.getAlgorithm(task.player2_idx).name(),
-                registrar.getAlgorithm(task.player1_idx).getTankAlgorithmFactory(),
-                registrar.getAlgorithm(task.player2_idx).getTankAlgorithmFactory());
+            std::vector<std::string> fields;
+            std::istringstream in(line);
+            for (std::string field; std::getline(in, field, '\t');)
+            {
+                fields.push_back(field);
+            }
 
-            // Update scores
+            GameOutcome outcome;
+            try
             {
-                std::lock_guard<std::mutex> lock(resultsMutex);
-                if (result.winner == 0)
-                {
-                    scores[registrar.getAlgorithm(task.player1_idx).name()] += 1;
-                    scores[registrar.getAlgorithm(task.player2_idx).name()] += 1;
-                }
-                else
+                if (fields.size() != 4 || !indexByName.count(fields[2]) || !indexByName.count(fields[3]))
                 {
-                    std::string winnerName = result.winner == 1 ? registrar.getAlgorithm(task.player1_idx).name() : registrar.getAlgorithm(task.player2_idx).name();
-                    scores[winnerName] += 3;
+                    throw std::runtime_error("unknown algorithm or malformed task: " + line);
                 }
+                auto [map, added] = mapIndexByName.try_emplace(fields[1], mapFiles.size());
+                if (added)
+                    mapFiles.push_back((fs::path(mapFolder) / fields[1]).string());
+                GameTask task{indexByName[fields[2]], indexByName[fields[3]], map->second, 0};
+                outcome = playGameTask(*gm, task, cachedMapFile, workerBoard);
+                played++;
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Error in worker for task " << (fields.empty() ? line : fields[0]) << ": " << e.what() << std::endl;
+            }
+
+            std::ostringstream result;
+            result << "RESULT " << (fields.empty() ? "0" : fields[0]) << " " << encodeOutcome(outcome);
+            if (!socket.sendLine(result.str()))
+            {
+                throw std::runtime_error("Lost connection to coordinator");
             }
-            completedTasks++;
         }
-        catch (const std::exception &e)
+    }
+
+    std::cout << "Worker finished after playing " << played << " games.\n";
+}
+
+// Keep plugins, boards and a pool of threads loaded across runs and play the jobs of runs with daemon=<socket>
+void Simulator::runDaemon()
+{
+    size_t poolSize = numThreads > 1 ? static_cast<size_t>(numThreads) : std::max(1u, std::thread::hardware_concurrency());
+    Daemon(*this, params.at("socket"), poolSize).run();
+}
+
+// With daemon=<socket>, the run is played by a running daemon instead of loading anything here. The
+// daemon writes the same result file; every game is printed to stdout as a JSON line as it finishes.
+void Simulator::submitToDaemon()
+{
+    std::string job = std::string("JOB ") + (mode == RunMode::COMPARATIVE ? "comparative" : "competition");
+    std::map<std::string, std::string> request = params;
+    request.erase("daemon");
+    request["cwd"] = fs::current_path().string();
+    if (verbose)
+        request["verbose"] = "1";
+    for (const auto &[key, value] : request)
+    {
+        if (value.find_first_of("\t\n") != std::string::npos)
+            throw std::invalid_argument(key + " cannot be passed to the daemon: " + value);
+        job += "\t" + key + "=" + value;
+    }
+
+    LineSocket socket = LineSocket::connectToUnix(params.at("daemon"));
+    if (!socket.sendLine(job))
+    {
+        throw std::runtime_error("Lost connection to the daemon");
+    }
+
+    std::string line;
+    while (socket.readLine(line))
+    {
+        if (line.rfind("GAME ", 0) == 0)
         {
-            std::cerr << "Error in worker thread for task " << task.taskId
-                      << ": " << e.what() << std::endl;
+            std::cout << line.substr(5) << "\n";
+        }
+        else if (line.rfind("DONE ", 0) == 0)
+        {
+            std::cout << "Results written to " << line.substr(5) << std::endl;
+            return;
+        }
+        else if (line.rfind("RELOAD ", 0) == 0)
+        {
+            std::cerr << "Daemon reloaded " << line.substr(7) << std::endl;
+        }
+        else if (line.rfind("ERROR ", 0) == 0)
+        {
+            throw std::runtime_error("Daemon: " + line.substr(6));
+        }
+    }
+    throw std::runtime_error("The daemon closed the connection before the job finished");
+}
+
+// Combine the result files of shard=i/n runs, collected in shards_folder, into the result file the whole
+// competition would have written. Files without a shard line, like an earlier merge, are ignored.
+void Simulator::mergeShards()
+{
+    std::string folder = params.at("shards_folder");
+    std::map<size_t, std::string> shards; // shard index -> file
+    std::string mapsFolder, gameManager, competition;
+    size_t count = 0;
+    std::map<std::string, int> scores;
+
+    for (const auto &file : sortedDirectoryFiles(folder, ".txt"))
+    {
+        std::ifstream in(file);
+        std::string mapsLine, gmLine, shardLine;
+        if (!std::getline(in, mapsLine) || !std::getline(in, gmLine) || !std::getline(in, shardLine) ||
+            shardLine.rfind("shard=", 0) != 0)
+        {
+            continue;
+        }
+        if (mapsLine.rfind("game_maps_folder=", 0) != 0 || gmLine.rfind("game_manager=", 0) != 0)
+            throw std::runtime_error("Malformed header in " + file);
+        mapsLine = mapsLine.substr(mapsLine.find('=') + 1);
+        gmLine = gmLine.substr(gmLine.find('=') + 1);
+
+        size_t index = 0, of = 0;
+        char id[17] = {};
+        if (sscanf(shardLine.c_str(), "shard=%zu/%zu competition=%16s", &index, &of, id) != 3 || index >= of)
+            throw std::runtime_error("Malformed shard line in " + file + ": " + shardLine);
+        if (shards.empty())
+        {
+            mapsFolder = mapsLine;
+            gameManager = gmLine;
+            competition = id;
+            count = of;
+        }
+        else if (competition != id || count != of || mapsFolder != mapsLine || gameManager != gmLine)
+        {
+            throw std::runtime_error(file + " is a shard of a different competition than " + shards.begin()->second);
+        }
+        if (!shards.emplace(index, file).second)
+            throw std::runtime_error("Shard " + std::to_string(index) + "/" + std::to_string(of) + " found twice: " + shards[index] + " and " + file);
+
+        std::string line;
+        while (std::getline(in, line))
+        {
+            size_t space = line.rfind(' ');
+            if (line.empty() || space == std::string::npos)
+                continue;
+            scores[line.substr(0, space)] += std::stoi(line.substr(space + 1));
         }
     }
+
+    if (shards.empty())
+        throw std::runtime_error("No shard result files in " + folder);
+    std::string missing;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!shards.count(i))
+            missing += " " + std::to_string(i);
+    }
+    if (!missing.empty())
+        throw std::runtime_error("Missing shards of " + std::to_string(count) + ":" + missing);
+
+    std::string outputFile = folder + "/competition_" + getTimeString() + ".txt";
+    std::ofstream out;
+    openResultFile(out, outputFile);
+    writeCompetitionResults(out, mapsFolder, gameManager, "", scores);
+    out.close();
+    std::cout << "Merged " << count << " shards into " << outputFile << "\n";
 }
 
 void Simulator::runComparativeThreaded(bool verbose)
@@ -738,27 +2424,7 @@ void Simulator::runComparativeThreaded(bool verbose)
     std::string timeStr = getTimeString();
     std::string outputFile = outputFolder + "/comparative_results_" + timeStr + ".txt";
 
-    std::ofstream out(outputFile);
-    if (!out)
-    {
-        std::cerr << "Cannot create output file: " << outputFile << ", printing to screen.\n";
-        out.basic_ios<char>::rdbuf(std::cout.rdbuf());
-    }
-
-    out << "game_map=" << mapFile << "\n";
-    out << "algorithm1=" << params.at("algorithm1") << "\n";
-    out << "algorithm2=" << params.at("algorithm2") << "\n\n";
-
-    // Create GameManager queue
-    std::queue<std::string> gmQueue;
-    std::mutex queueMutex;
-
-    for (auto &gmEntry : gmRegistrar.getGM())
-    {
-        gmQueue.push(gmEntry.name);
-    }
-
-    size_t totalGMs = gmQueue.size();
+    size_t totalGMs = gmRegistrar.count();
     int actualThreads = getOptimalThreadCount(totalGMs);
 
     if (actualThreads == 1)
@@ -767,6 +2433,17 @@ void Simulator::runComparativeThreaded(bool verbose)
         return;
     }
 
+    mapMemory.assign(1, estimateTaskMemory(mapFile));
+    openMemoryGate(memoryState, actualThreads);
+
+    // Every game runs on the same map, so game managers are simply dealt out round-robin
+    WorkStealingScheduler<std::string> scheduler(actualThreads);
+    size_t next = 0;
+    for (auto &gmEntry : gmRegistrar.getGM())
+    {
+        scheduler.push(next++ % actualThreads, gmEntry.name);
+    }
+
     // Shared results map
     std::map<std::string, ComparativeResult> groupedResults;
 
@@ -774,7 +2451,7 @@ void Simulator::runComparativeThreaded(bool verbose)
     for (int i = 0; i < actualThreads; ++i)
     {
         workers.emplace_back(&Simulator::comparativeWorker, this,
-                             std::ref(gmQueue), std::ref(queueMutex),
+                             std::ref(scheduler), static_cast<size_t>(i),
                              std::ref(groupedResults), mapFile, verbose);
     }
 
@@ -784,43 +2461,14 @@ void Simulator::runComparativeThreaded(bool verbose)
         worker.join();
     }
 
-    bool first = true;
-    for (auto &[key, group] : groupedResults)
-    {
-        if (!first)
-            out << "\n";
-        first = false;
-
-        for (size_t i = 0; i < group.gmNames.size(); i++)
-        {
-            if (i > 0)
-                out << ",";
-            out << group.gmNames[i];
-        }
-        out << "\n";
-
-        if (group.result.winner == 0)
-        {
-            if (group.result.reason == GameResult::Reason::ALL_TANKS_DEAD)
-                out << "Tie, reason: ALL_TANKS_DEAD\n";
-            else if (group.result.reason == GameResult::Reason::MAX_STEPS)
-                out << "Tie, reason: MAX_STEPS\n";
-            else if (group.result.reason == GameResult::Reason::ZERO_SHELLS)
-                out << "Tie, reason: ZERO_SHELLS\n";
-        }
-        else
-        {
-            out << "Player " << group.result.winner << " won, reason: ALL_TANKS_DEAD\n";
-        }
-
-        out << group.result.rounds << "\n";
-        out << gameStateToString(group.result, board->getWidth(), board->getHeight()) << "\n";
-    }
+    std::ofstream out;
+    openResultFile(out, outputFile);
+    writeComparativeResults(out, mapFile, params.at("algorithm1"), params.at("algorithm2"), groupedResults);
 }
 
 void Simulator::comparativeWorker(
-    std::queue<std::string> &gmQueue,
-    std::mutex &queueMutex,
+    WorkStealingScheduler<std::string> &scheduler,
+    size_t workerIndex,
     std::map<std::string, ComparativeResult> &groupedResults,
     const std::string &mapFile,
     bool verbose)
@@ -828,33 +2476,35 @@ void Simulator::comparativeWorker(
     auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
     auto &gmRegistrar = GameManagerRegistrar::getGameManagerRegistrar();
 
-    while (true)
-    {
-        std::string gmName;
-
-        // Get next GameManager from queue
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            if (gmQueue.empty())
-            {
-                break; // No more GameManagers to process
-            }
-            gmName = gmQueue.front();
-            gmQueue.pop();
-        }
+    if (tracer)
+        tracer->attachThread("worker " + std::to_string(workerIndex));
 
+    std::string gmName;
+    MemoryGate::Holder memory;
+    while (scheduler.pop(workerIndex, gmName))
+    {
         try
         {
+            MemoryGate::Admission admission(*memoryGate, memory, mapMemory[0]);
+            auto mapName = fs::path(mapFile).stem().string();
+            TraceRecorder::Span gameSpan("game");
+            if (tracer)
+                gameSpan.setArgs(TraceRecorder::args({{"map", mapName}, {"game_manager", gmName}}));
+
             // Load board for this thread
             auto threadBoard = createGameBoard(mapFile);
 
             // Create players
-            auto p1 = registrar.getAlgorithm(0).createPlayer(
-                1, threadBoard->getWidth(), threadBoard->getHeight(),
-                threadBoard->getMaxSteps(), 0);
-            auto p2 = registrar.getAlgorithm(1).createPlayer(
-                2, threadBoard->getWidth(), threadBoard->getHeight(),
-                threadBoard->getMaxSteps(), 0);
+            std::unique_ptr<Player> p1, p2;
+            {
+                TraceRecorder::Span span("create players");
+                p1 = registrar.getAlgorithm(0).createPlayer(
+                    1, threadBoard->getWidth(), threadBoard->getHeight(),
+                    threadBoard->getMaxSteps(), 0);
+                p2 = registrar.getAlgorithm(1).createPlayer(
+                    2, threadBoard->getWidth(), threadBoard->getHeight(),
+                    threadBoard->getMaxSteps(), 0);
+            }
 
             auto gmEntry = std::find_if(gmRegistrar.getGM().begin(), gmRegistrar.getGM().end(),
                                         [&gmName](const auto &entry)
@@ -865,20 +2515,24 @@ void Simulator::comparativeWorker(
             }
 
             auto gm = gmEntry->create(verbose);
-            auto sat = UserCommon_318885712_208230862::SatelliteViewImpl(*threadBoard, Position(-1, -1));
-            auto mapName = fs::path(mapFile).stem().string();
-            GameResult result = gm->run(
-                threadBoard->getWidth(), threadBoard->getHeight(),
-                dynamic_cast<SatelliteView &>(sat), mapName,
-                threadBoard->getMaxSteps(), threadBoard->getNumShells(),
-                *p1, registrar.getAlgorithm(0).name(),
-                *p2, registrar.getAlgorithm(1).name(),
-                registrar.getAlgorithm(0).getTankAlgorithmFactory(),
-                registrar.getAlgorithm(1).getTankAlgorithmFactory());
+            auto sat = SatelliteViewImpl(*threadBoard, Position(-1, -1));
+            GameResult result;
+            {
+                TraceRecorder::Span span("gm.run");
+                TraceRecorder::StepSpans steps(stepObserverOf(gmName));
+                result = gm->run(
+                    threadBoard->getWidth(), threadBoard->getHeight(),
+                    dynamic_cast<SatelliteView &>(sat), mapName,
+                    threadBoard->getMaxSteps(), threadBoard->getNumShells(),
+                    *p1, registrar.getAlgorithm(0).name(),
+                    *p2, registrar.getAlgorithm(1).name(),
+                    registrar.getAlgorithm(0).getTankAlgorithmFactory(),
+                    registrar.getAlgorithm(1).getTankAlgorithmFactory());
+            }
 
+            std::string finalState = gameStateToString(result, threadBoard->getWidth(), threadBoard->getHeight());
             std::ostringstream sig;
-            sig << result.winner << "|" << result.reason << "|" << result.rounds << "|"
-                << gameStateToString(result, threadBoard->getWidth(), threadBoard->getHeight());
+            sig << result.winner << "|" << result.reason << "|" << result.rounds << "|" << finalState;
 
             std::string key = sig.str();
 
@@ -886,9 +2540,8 @@ void Simulator::comparativeWorker(
                 std::lock_guard<std::mutex> lock(resultsMutex);
                 groupedResults[key].result = std::move(result);
                 groupedResults[key].gmNames.push_back(gmName);
+                groupedResults[key].finalState = finalState;
             }
-
-            completedTasks++;
         }
         catch (const std::exception &e)
         {
@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <fstream>
 #include <thread>
 #include <mutex>
 #include <queue>
@@ -11,11 +12,32 @@
 #include "common/Player.h"
 #include "GameBoard.h"
 #include "common/GameResult.h"
+#include "WorkStealingScheduler.h"
+#include "CompetitionTasks.h"
+#include "SharedTaskArea.h"
+#include "LineSocket.h"
+#include "ResultsLog.h"
+#include "CompetitionJournal.h"
+#include "ResultCache.h"
+#include "Metrics.h"
+#include "PluginCache.h"
+#include "ContentHash.h"
+#include "FairShareQueue.h"
+#include "MemoryGate.h"
+#include "TraceRecorder.h"
+#include "GameManagerRegistrar.h"
+#include <chrono>
+#include "common/AbstractGameManager.h"
+#include <sys/types.h>
 
 enum class RunMode
 {
     COMPETITION,
     COMPARATIVE,
+    COORDINATOR,
+    WORKER,
+    DAEMON,
+    MERGE,
     UNKNOWN
 };
 
@@ -29,14 +51,17 @@ struct ComparativeResult
 {
     std::vector<std::string> gmNames;
     GameResult result;
+    std::string finalState; // gameStateToString of the result
 };
 
-struct GameTask
+// Per-algorithm tally of one competition worker, indexed like the algorithm registrar
+struct AlgorithmStats
 {
-    size_t player1_idx;
-    size_t player2_idx;
-    std::string mapFile;
-    size_t taskId;
+    int score = 0;
+    size_t wins = 0;
+    size_t ties = 0;
+    size_t losses = 0;
+    size_t rounds = 0;
 };
 
 struct GameTaskResult
@@ -48,6 +73,21 @@ struct GameTaskResult
     GameResult result;
 };
 
+// File names in a directory in sorted order, optionally only those with the given extension
+std::vector<std::string> sortedDirectoryFiles(const std::string &directoryPath, const std::string &extension);
+// The final board of a game, one line per row
+std::string gameStateToString(const GameResult &result, size_t width, size_t height);
+// Opens a result file; if it cannot be created, out writes to stdout instead
+void openResultFile(std::ofstream &out, const std::string &outputFile);
+// The result file of a competition: its maps folder and game manager, the shard line of a shard, then
+// every algorithm by descending score
+void writeCompetitionResults(std::ostream &out, const std::string &mapsFolder, const std::string &gameManager,
+                             const std::string &shardHeader, const std::map<std::string, int> &scores);
+// The result file of a comparison: its map and algorithms, then every group of game managers whose games
+// ended the same way
+void writeComparativeResults(std::ostream &out, const std::string &gameMap, const std::string &algorithm1,
+                             const std::string &algorithm2, const std::map<std::string, ComparativeResult> &groupedResults);
+
 class Simulator
 {
 public:
@@ -62,9 +102,13 @@ public:
     const std::map<std::string, std::string> &getParams() const { return params; }
 
 private:
+    // The daemon loads plugins and maps the way a run does, and shares the memory gate
+    friend class Daemon;
+
     RunMode mode;
     bool verbose = false;
     int numThreads = 1;
+    int numProcesses = 1;
 
     std::map<std::string, std::string> params;
     std::unique_ptr<UserCommon::GameBoard> board;
@@ -80,7 +124,30 @@ private:
     std::vector<AlgorithmEntry> loadedAlgorithms;
 
     std::mutex resultsMutex;
-    std::atomic<size_t> completedTasks{0};
+    std::unique_ptr<ResultsLog> resultsLog;
+    std::unique_ptr<CompetitionJournal> journal;
+    std::unique_ptr<ResultCache> resultCache;
+    std::unique_ptr<PluginCache> pluginCache;
+    uint64_t gameManagerHash = 0;
+    std::vector<uint64_t> algorithmHashes;   // by algorithm index
+    std::vector<uint64_t> mapHashes;         // by map index
+    std::vector<char> deterministicAlgorithms;
+    std::atomic<size_t> cacheHits{0};
+    std::atomic<size_t> cacheVerified{0};
+    std::atomic<size_t> cacheMismatches{0};
+    std::unique_ptr<MetricsRegistry> metrics; // only while progress= or metrics_file= reporting runs
+    std::vector<std::string> mapFiles; // competition maps, indexed by GameTask::mapIndex
+    std::vector<uint64_t> mapMemory;   // estimated bytes of one game, by map index
+    MemoryGate::State memoryState;     // of the game threads; worker processes share the one in SharedTaskArea
+    std::unique_ptr<MemoryGate> memoryGate;
+    bool measurePeakRss = false; // only where a process plays one game at a time; threads share one RSS
+    size_t shardIndex = 0;       // shard=i/n
+    size_t shardCount = 1;
+    std::vector<size_t> playerSlots;              // of a shard: algorithm file index -> registrar index
+    std::vector<std::string> shardAlgorithmNames; // of a shard: every algorithm file, loaded or not
+    std::string shardHeader;                      // of a shard: its line in the result file
+    std::unique_ptr<TraceRecorder> tracer;        // only with trace=
+    std::map<std::string, TraceRecorder::StepObserverSetter> stepObservers; // by game manager name, of those that export one
 
     void parseArguments(int argc, char *argv[]);
     void validateRequiredParams();
@@ -88,7 +155,7 @@ private:
     std::string getTimeString() const;
 
     bool loadBoard(const std::string &path);
-    void loadSharedObjectFromFile(const std::string &filePath, SharedObjectType type);
+    double loadSharedObjectFromFile(const std::string &filePath, SharedObjectType type, const std::string &loadFrom = "");
     void loadSharedObjectsFromDirectory(const std::string &directoryPath, SharedObjectType type);
 
     void runCompetition(bool verbose);
@@ -99,20 +166,65 @@ private:
     void runComparativeThreaded(bool verbose);
 
     void competitionWorker(
-        const std::vector<std::string> &maps,
-        std::queue<GameTask> &taskQueue,
-        std::mutex &queueMutex,
-        std::map<std::string, int> &scores,
+        WorkStealingScheduler<TaskRange> &scheduler,
+        size_t workerIndex,
+        const CompetitionTasks &tasks,
+        std::vector<AlgorithmStats> &stats,
         bool verbose);
 
     void comparativeWorker(
-        std::queue<std::string> &gmQueue,
-        std::mutex &queueMutex,
+        WorkStealingScheduler<std::string> &scheduler,
+        size_t workerIndex,
         std::map<std::string, ComparativeResult> &groupedResults,
         const std::string &mapFile,
         bool verbose);
 
+    void runCompetitionProcesses(bool verbose);
+    pid_t spawnProcessWorker(SharedTaskArea &area, size_t w, const CompetitionTasks &tasks, bool verbose);
+    void processWorker(SharedTaskArea &area, size_t w, const CompetitionTasks &tasks, bool verbose);
+    void applyProcessLimits() const;
+    void armGameCpuLimit() const;
+
+    void runCoordinator();
+    void runWorker(bool verbose);
+    void runDaemon();
+    void submitToDaemon();
+
     int getOptimalThreadCount(size_t totalTasks) const;
 
+    size_t estimateTaskCost(const std::string &mapFile) const;
+    uint64_t estimateTaskMemory(const std::string &mapFile) const;
+    void openMemoryGate(MemoryGate::State &state, size_t workers);
+    void distributeTasks(const CompetitionTasks &tasks, WorkStealingScheduler<TaskRange> &scheduler) const;
+
+    CompetitionTasks::Pairing competitionPairing() const;
+    // Also sets mapFiles and mapMemory
+    CompetitionTasks makeCompetitionTasks(const std::vector<std::string> &maps, size_t algorithmCount);
+    void loadCompetitionAlgorithms();
+    void mergeShards();
+    GameOutcome playGameTask(AbstractGameManager &gm, const GameTask &task,
+                            std::string &cachedMapFile, std::unique_ptr<UserCommon::GameBoard> &gameBoard) const;
+    static void addGameResult(std::vector<AlgorithmStats> &stats, const GameTask &task, int winner, size_t rounds);
+    static GameOutcome makeOutcome(const GameResult &result, std::chrono::steady_clock::time_point start);
+    // Appends the game to the results_log stream and the journal, if they were requested
+    void logGame(const GameTask &task, const std::string &player1, const std::string &player2, const GameOutcome &outcome);
+    std::vector<std::string> registeredAlgorithmNames() const;
+    void hashGameManager(ContentHash &hash) const;
+    void hashAlgorithms(ContentHash &hash, const std::vector<std::string> &algorithmNames) const;
+    void hashMaps(ContentHash &hash, const std::vector<std::string> &maps) const;
+    std::string inputHashes(const std::vector<std::string> &algorithmNames, const std::vector<std::string> &maps) const;
+    std::string competitionFingerprint(const std::vector<std::string> &algorithmNames, const std::vector<std::string> &maps,
+                                       CompetitionTasks::Pairing pairing, uint64_t games) const;
+    std::vector<AlgorithmStats> resumeFromJournal(const CompetitionTasks &tasks, const std::vector<std::string> &algorithmNames);
+    bool alreadyPlayed(const GameTask &task) const; // in the journal of a resumed competition
+    size_t journaledGames() const;
+    void openResultCache(const std::vector<std::string> &algorithmNames);
+    bool cacheKey(const GameTask &task, uint64_t &key) const;
+    bool cachedOutcome(const GameTask &task, GameOutcome &out) const;
+    void checkAgainstCache(const GameTask &task, GameOutcome &outcome) const;
+    std::unique_ptr<MetricsReporter> startMetrics(size_t workers, uint64_t totalGames, std::function<uint64_t()> queueDepth, bool busyIsTotal = false);
+    void recordMetrics(size_t worker, const GameOutcome &outcome);
+
     std::unique_ptr<UserCommon::GameBoard> createGameBoard(const std::string &mapFile) const;
+    TraceRecorder::StepObserverSetter stepObserverOf(const std::string &gameManager) const;
 };
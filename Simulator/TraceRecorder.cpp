@@ -0,0 +1,249 @@
+#include "TraceRecorder.h"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+thread_local TraceRecorder::Track *TraceRecorder::current = nullptr;
+
+namespace
+{
+    std::string jsonString(const std::string &value)
+    {
+        std::string escaped = "\"";
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                std::ostringstream code;
+                code << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c);
+                escaped += code.str();
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+        return escaped + "\"";
+    }
+
+    // Parts are written next to the trace file as <file>.part.<pid>
+    std::string partPrefix(const std::string &path)
+    {
+        return fs::path(path).filename().string() + ".part.";
+    }
+
+    fs::path partDirectory(const std::string &path)
+    {
+        fs::path directory = fs::path(path).parent_path();
+        return directory.empty() ? fs::path(".") : directory;
+    }
+
+    std::vector<fs::path> partFiles(const std::string &path)
+    {
+        std::vector<fs::path> parts;
+        std::error_code ec;
+        std::string prefix = partPrefix(path);
+        for (const auto &entry : fs::directory_iterator(partDirectory(path), ec))
+        {
+            if (entry.path().filename().string().rfind(prefix, 0) == 0)
+                parts.push_back(entry.path());
+        }
+        return parts;
+    }
+}
+
+TraceRecorder::TraceRecorder(std::string path, size_t eventsPerTrack)
+    : path(std::move(path)), processName("simulator"), eventsPerTrack(eventsPerTrack), originNs(now())
+{
+    // Left over from a run that did not finish; they would be merged into this one
+    for (const auto &part : partFiles(this->path))
+        fs::remove(part);
+}
+
+TraceRecorder::Span::~Span()
+{
+    if (active())
+        record(name, beginNs, now(), std::move(args), false);
+}
+
+TraceRecorder::StepSpans::StepSpans(StepObserverSetter setter) : setter(active() ? setter : nullptr)
+{
+    if (this->setter)
+    {
+        lastNs = now();
+        this->setter(mark, this, false);
+    }
+}
+
+TraceRecorder::StepSpans::~StepSpans()
+{
+    if (!setter)
+        return;
+    setter(nullptr, nullptr, false);
+    if (stepped)
+        record("result", lastNs, now(), "", true);
+}
+
+// Called once the game is set up and after every step; steps alternate between tanks and shells, tanks first
+void TraceRecorder::StepSpans::mark(void *context, size_t step, const char *, size_t)
+{
+    auto *spans = static_cast<StepSpans *>(context);
+    int64_t time = now();
+    const char *name = step == 0 ? "setup" : (step % 2 == 1 ? "tank step" : "shell step");
+    record(name, spans->lastNs, time, "", true);
+    spans->lastNs = time;
+    spans->stepped = true;
+}
+
+void TraceRecorder::attachThread(const std::string &name)
+{
+    auto track = std::make_unique<Track>();
+    track->name = name;
+    track->capacity = eventsPerTrack;
+    track->events.reset(new Event[eventsPerTrack]); // left uninitialized, so untouched pages cost nothing
+    current = track.get();
+
+    std::lock_guard<std::mutex> lock(tracksMutex);
+    track->id = static_cast<int>(tracks.size()) + 1;
+    tracks.push_back(std::move(track));
+}
+
+void TraceRecorder::record(const char *name, int64_t beginNs, int64_t endNs, std::string args, bool step)
+{
+    Track &track = *current;
+    size_t index = track.count.load(std::memory_order_relaxed);
+    // The last eighth is kept for spans that are not steps, so a long run still shows every game
+    size_t limit = step ? track.capacity - track.capacity / 8 : track.capacity;
+    if (index >= limit)
+    {
+        (step ? track.droppedSteps : track.dropped)++;
+        return;
+    }
+
+    size_t argsIndex = 0;
+    if (!args.empty())
+    {
+        track.args.push_back(std::move(args));
+        argsIndex = track.args.size();
+    }
+    track.events[index] = {name, beginNs, endNs, argsIndex};
+    track.count.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::writeEvents(std::ostream &out, const char *separator, bool &first) const
+{
+    auto separate = [&out, separator, &first]
+    {
+        if (!first)
+            out << separator;
+        first = false;
+    };
+    int pid = static_cast<int>(getpid());
+
+    separate();
+    out << "{\"ph\": \"M\", \"name\": \"process_name\", \"pid\": " << pid << ", \"tid\": 0, \"args\": {\"name\": " << jsonString(processName) << "}}";
+    out << std::fixed << std::setprecision(3);
+    for (const auto &track : tracks)
+    {
+        separate();
+        out << "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": " << pid << ", \"tid\": " << track->id
+            << ", \"args\": {\"name\": " << jsonString(track->name) << "}}";
+
+        size_t count = track->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Event &event = track->events[i];
+            separate();
+            out << "{\"ph\": \"X\", \"name\": \"" << event.name << "\", \"pid\": " << pid << ", \"tid\": " << track->id
+                << ", \"ts\": " << (event.beginNs - originNs) / 1000.0 << ", \"dur\": " << (event.endNs - event.beginNs) / 1000.0;
+            if (event.args > 0)
+                out << ", \"args\": " << track->args[event.args - 1];
+            out << "}";
+        }
+    }
+}
+
+size_t TraceRecorder::dropCounts(size_t &droppedSteps) const
+{
+    size_t dropped = 0;
+    droppedSteps = 0;
+    for (const auto &track : tracks)
+    {
+        dropped += track->dropped;
+        droppedSteps += track->droppedSteps;
+    }
+    return dropped;
+}
+
+void TraceRecorder::writePart() const
+{
+    std::string part = (partDirectory(path) / (partPrefix(path) + std::to_string(getpid()))).string();
+    std::ofstream out(part);
+    // One event per line, which write() joins into its list
+    bool first = true;
+    writeEvents(out, "\n", first);
+    out << "\n";
+    if (!out)
+        std::cerr << "Failed to write trace part " << part << "\n";
+
+    size_t droppedSteps = 0;
+    size_t dropped = dropCounts(droppedSteps);
+    if (dropped + droppedSteps > 0)
+        std::cerr << "Trace of process " << getpid() << ": " << droppedSteps << " step spans and " << dropped << " other spans did not fit\n";
+}
+
+void TraceRecorder::write() const
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        std::cerr << "Cannot create trace file: " << path << "\n";
+        return;
+    }
+
+    out << "{\"traceEvents\": [\n";
+    bool first = true;
+    writeEvents(out, ",\n", first);
+    for (const auto &part : partFiles(path))
+    {
+        std::ifstream in(part);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty())
+                continue;
+            out << ",\n" << line;
+        }
+        in.close();
+        fs::remove(part);
+    }
+    out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+
+    size_t droppedSteps = 0;
+    size_t dropped = dropCounts(droppedSteps);
+    if (dropped + droppedSteps > 0)
+        std::cerr << "Trace: " << droppedSteps << " step spans and " << dropped << " other spans did not fit\n";
+    std::cout << "Trace written to " << path << "\n";
+}
+
+std::string TraceRecorder::args(std::initializer_list<std::pair<const char *, std::string>> fields)
+{
+    std::string json = "{";
+    for (const auto &[key, value] : fields)
+    {
+        if (json.size() > 1)
+            json += ", ";
+        json += jsonString(key) + ": " + jsonString(value);
+    }
+    return json + "}";
+}
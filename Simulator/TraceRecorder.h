@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Records spans of the game threads for a Chrome/Perfetto trace-event JSON file (trace=). Every thread
+// that attaches gets its own track and appends to its own preallocated buffer without locks or
+// allocation, apart from the arguments of a game span. Nothing is written until the run is over.
+// A full buffer keeps room for game spans by dropping step spans first, and counts what it dropped.
+class TraceRecorder
+{
+public:
+    // Per-step callbacks a game manager may export as tankgame_set_step_observer
+    using StepObserver = void (*)(void *context, size_t step, const char *state, size_t length);
+    using StepObserverSetter = void (*)(StepObserver observer, void *context, bool withState);
+
+    // Times spans from construction to destruction on the calling thread's track, if it has one
+    class Span
+    {
+    private:
+        const char *name;
+        int64_t beginNs;
+        std::string args;
+
+    public:
+        explicit Span(const char *name) : name(name), beginNs(active() ? now() : 0) {}
+        ~Span();
+
+        // A JSON object shown with the span
+        void setArgs(std::string json)
+        {
+            if (active())
+                args = std::move(json);
+        }
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+    };
+
+    // Splits a game manager run into setup, tank steps, shell steps and building the result, by the
+    // step callbacks of a game manager that exports them; a no-op without a track or a setter
+    class StepSpans
+    {
+    private:
+        StepObserverSetter setter;
+        int64_t lastNs = 0;
+        bool stepped = false;
+
+        static void mark(void *context, size_t step, const char *state, size_t length);
+
+    public:
+        explicit StepSpans(StepObserverSetter setter);
+        ~StepSpans();
+
+        StepSpans(const StepSpans &) = delete;
+        StepSpans &operator=(const StepSpans &) = delete;
+    };
+
+private:
+    struct Event
+    {
+        const char *name;
+        int64_t beginNs;
+        int64_t endNs;
+        size_t args; // 1 + index into Track::args, 0 for none
+    };
+
+    struct Track
+    {
+        std::string name;
+        int id;
+        size_t capacity;
+        std::unique_ptr<Event[]> events;
+        std::atomic<size_t> count{0};
+        std::vector<std::string> args; // only touched by the owning thread until the run is over
+        size_t droppedSteps = 0;
+        size_t dropped = 0;
+    };
+
+    std::string path;
+    std::string processName;
+    size_t eventsPerTrack;
+    int64_t originNs;
+
+    std::mutex tracksMutex;
+    std::vector<std::unique_ptr<Track>> tracks;
+
+    static thread_local Track *current;
+
+    static int64_t now() { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+    static bool active() { return current != nullptr; }
+    static void record(const char *name, int64_t beginNs, int64_t endNs, std::string args, bool step);
+
+    void writeEvents(std::ostream &out, const char *separator, bool &first) const;
+    size_t dropCounts(size_t &droppedSteps) const;
+
+public:
+    static constexpr size_t DEFAULT_EVENTS_PER_TRACK = 1 << 20;
+
+    explicit TraceRecorder(std::string path, size_t eventsPerTrack = DEFAULT_EVENTS_PER_TRACK);
+
+    // Gives the calling thread a track of its own, shown as name; it records until detachThread()
+    void attachThread(const std::string &name);
+    static void detachThread() { current = nullptr; }
+
+    // Names the tracks of this process, e.g. after fork() in a worker process
+    void setProcessName(const std::string &name) { processName = name; }
+
+    // Writes the events of this process for write() of the parent to pick up; for forked workers
+    void writePart() const;
+    // Writes the trace file with the events of this process and of every part written by its workers
+    void write() const;
+
+    // A JSON object of string fields, for Span::setArgs
+    static std::string args(std::initializer_list<std::pair<const char *, std::string>> fields);
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+// Per-worker task deques for a fixed batch of tasks.
+// Tasks are distributed up front; a worker takes from the front of its own deque and,
+// once that is empty, steals from the back of the others.
+template <typename Task>
+class WorkStealingScheduler
+{
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+public:
+    explicit WorkStealingScheduler(size_t workerCount)
+    {
+        for (size_t i = 0; i < workerCount; ++i)
+            queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    size_t workerCount() const { return queues.size(); }
+
+    void push(size_t worker, Task task)
+    {
+        auto &queue = *queues.at(worker);
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    // Puts a task back at the front of the worker's own deque, e.g. the rest of a split range
+    void pushFront(size_t worker, Task task)
+    {
+        auto &queue = *queues.at(worker);
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_front(std::move(task));
+    }
+
+    // Next task for the worker; false once every deque is empty
+    bool pop(size_t worker, Task &out)
+    {
+        {
+            auto &own = *queues.at(worker);
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                out = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues.size(); ++offset)
+        {
+            auto &victim = *queues[(worker + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                out = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Calls f on every queued task, one deque at a time
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (const auto &queue : queues)
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            for (const auto &task : queue->tasks)
+                f(task);
+        }
+    }
+
+    size_t size() const
+    {
+        size_t total = 0;
+        for (const auto &queue : queues)
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            total += queue->tasks.size();
+        }
+        return total;
+    }
+};
@@ -0,0 +1,98 @@
+#include "TestSupport.h"
+#include "Simulator/LineSocket.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace
+{
+    string workerCommand(const fs::path &dir, const string &maps, int port)
+    {
+        return "./Simulator/simulator -worker game_maps_folder=" + maps + " game_manager=GameManager/GameManager.so"
+               " algorithms_folder=" + (dir / "algs").string() + " coordinator=127.0.0.1:" + to_string(port);
+    }
+
+    LineSocket connectWithRetries(int port)
+    {
+        for (int attempt = 0;; ++attempt)
+        {
+            try
+            {
+                return LineSocket::connectTo("127.0.0.1", to_string(port));
+            }
+            catch (const exception &)
+            {
+                if (attempt >= 100)
+                    throw;
+                this_thread::sleep_for(chrono::milliseconds(100));
+            }
+        }
+    }
+
+    bool waitForFile(const fs::path &path)
+    {
+        for (int i = 0; i < 600 && !fs::exists(path); ++i)
+            this_thread::sleep_for(chrono::milliseconds(100));
+        return fs::exists(path);
+    }
+}
+
+// A worker whose maps differ from the coordinator's gets no games, and the games of a worker that takes a
+// batch and never reports go to another worker after batch_timeout_sec
+int main()
+{
+    auto dir = Tests::workDir("coordinator");
+    Tests::copyAlgorithms(dir / "algs", {"A", "B", "C"});
+    CHECK(Tests::generateMaps(dir / "maps", "count=3 rows=10 cols=12 max_steps=150 seed=6"));
+    string maps = (dir / "maps").string();
+    int port = 20000 + getpid() % 20000;
+
+    Tests::run("(./Simulator/simulator -coordinator game_maps_folder=" + maps + " game_manager=GameManager/GameManager.so"
+               " algorithms_folder=" + (dir / "algs").string() + " port=" + to_string(port) + " batch_size=1000"
+               " batch_timeout_sec=1 > " + (dir / "coordinator.txt").string() + " 2>&1; echo $? > " +
+               (dir / "coordinator_status").string() + ") &");
+
+    // Same map names, one of them with other contents
+    fs::copy(dir / "maps", dir / "changed_maps");
+    CHECK(Tests::generateMaps(dir / "regenerated", "count=3 rows=10 cols=12 max_steps=150 seed=7"));
+    fs::copy_file(dir / "regenerated" / "m_2", dir / "changed_maps" / "m_2", fs::copy_options::overwrite_existing);
+    CHECK(Tests::run(workerCommand(dir, (dir / "changed_maps").string(), port) + " > " +
+                     (dir / "changed_worker.txt").string() + " 2>&1") != 0);
+    CHECK(Tests::readFile(dir / "changed_worker.txt").find("maps differ") != string::npos);
+
+    // Stands in for a hung worker: greets with the hashes of a real one, takes all games and goes silent
+    int relayPort = port + 1;
+    int listenFd = LineSocket::listenOn(static_cast<uint16_t>(relayPort));
+    Tests::run(workerCommand(dir, maps, relayPort) + " > " + (dir / "hung_worker.txt").string() + " 2>&1 &");
+    LineSocket worker(accept(listenFd, nullptr, nullptr));
+    LineSocket coordinator = connectWithRetries(port);
+    string line;
+    bool relayed = worker.readLine(line) && line.rfind("HELLO ", 0) == 0 && coordinator.sendLine(line) &&
+                   coordinator.readLine(line) && line == "WELCOME" && worker.sendLine(line) &&
+                   worker.readLine(line) && line == "READY" && coordinator.sendLine(line) &&
+                   coordinator.readLine(line) && line.rfind("TASKS ", 0) == 0;
+    CHECK(relayed);
+
+    CHECK(Tests::run(workerCommand(dir, maps, port) + " > /dev/null 2>&1") == 0);
+    CHECK(waitForFile(dir / "coordinator_status"));
+    CHECK(Tests::readFile(dir / "coordinator_status") == "0\n");
+    string output = Tests::readFile(dir / "coordinator.txt");
+    CHECK(output.find("no result for 1 s") != string::npos);
+    CHECK(output.find("not scored") == string::npos);
+
+    size_t results = 0;
+    for (const auto &entry : fs::directory_iterator(dir / "algs"))
+        results += entry.path().extension() == ".txt";
+    CHECK(results == 1);
+
+    worker.close();
+    coordinator.close();
+    ::close(listenFd);
+    return Tests::finish("CoordinatorTest");
+}
@@ -0,0 +1,24 @@
+#include "TestSupport.h"
+#include <filesystem>
+#include <string>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// engine_diff compares builds as they are: a candidate whose own UserCommon moves tanks differently
+// diverges from the reference (exit code 2), while a copy of the reference does not
+int main()
+{
+    auto dir = Tests::workDir("engine_diff");
+    fs::copy_file("GameManager/GameManager.so", dir / "Copy.so");
+    CHECK(Tests::buildSkewedGameManager(dir / "Skewed.so"));
+
+    // Wider than 64 columns, so the game manager moves tanks through Position
+    string diff = "./Benchmark/engine_diff reference=GameManager/GameManager.so width=80 height=40 games=10 repeats=1 repro=" +
+                  (dir / "repro").string() + " candidate=";
+    CHECK(Tests::run(diff + (dir / "Copy.so").string() + " > /dev/null 2>&1") == 0);
+    CHECK(Tests::run(diff + (dir / "Skewed.so").string() + " > /dev/null 2>&1") == 2);
+    CHECK(fs::exists(dir / "repro" / "map.txt"));
+
+    return Tests::finish("EngineDiffTest");
+}
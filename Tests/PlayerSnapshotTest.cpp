@@ -0,0 +1,86 @@
+#include "TestSupport.h"
+#include "Algorithm/Player.h"
+#include "Algorithm/WorldSnapshot.h"
+#include "common/SatelliteView.h"
+#include "common/TankAlgorithm.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using UserCommon::Position;
+
+// A view over rows of satellite chars, '&' outside
+class GridView : public SatelliteView
+{
+private:
+    vector<string> rows;
+
+public:
+    explicit GridView(vector<string> rows) : rows(std::move(rows)) {}
+    char getObjectAt(size_t x, size_t y) const override
+    {
+        return y < rows.size() && x < rows[y].size() ? rows[y][x] : '&';
+    }
+};
+
+// Keeps what the player handed over
+class ProbeTank : public TankAlgorithm
+{
+public:
+    shared_ptr<const Algorithm::WorldSnapshot> snapshot;
+    Position self;
+
+    ActionRequest getAction() override { return ActionRequest::DoNothing; }
+    void updateBattleInfo(BattleInfo &info) override
+    {
+        auto &snapshotInfo = dynamic_cast<Algorithm::SnapshotInfo &>(info);
+        snapshot = snapshotInfo.getSnapshot();
+        self = snapshotInfo.getSelf();
+    }
+};
+
+// Two tanks of player 1 ask in the same step, as GameManager_A hands out views: one after the other,
+// with whatever the earlier tanks did in that step already on the board
+int main()
+{
+    Algorithm::MyPlayer player(1, 6, 3, 100, 5);
+    ProbeTank first, second, third;
+
+    player.updateTankWithBattleInfo(first, *make_unique<GridView>(vector<string>{
+                                               "%  1  ",
+                                               " #  @ ",
+                                               "    2 "}));
+    CHECK(first.snapshot);
+    CHECK(first.self == Position(0, 0));
+
+    // Same board, another tank asking: the snapshot is shared and only the asking tank differs
+    player.updateTankWithBattleInfo(second, *make_unique<GridView>(vector<string>{
+                                                "1  %  ",
+                                                " #  @ ",
+                                                "    2 "}));
+    CHECK(second.snapshot == first.snapshot);
+    CHECK(second.self == Position(3, 0));
+
+    // The first tank fired before the third one asked: the shell must be in what the third tank sees
+    player.updateTankWithBattleInfo(third, *make_unique<GridView>(vector<string>{
+                                               "*  1  ",
+                                               " #  @ ",
+                                               "    % "}));
+    CHECK(third.snapshot != first.snapshot);
+    CHECK(third.self == Position(4, 2));
+    CHECK(third.snapshot->getWorld().getShells() == vector<Position>{Position(0, 0)});
+    CHECK(third.snapshot->getWorld().at(Position(4, 2)) == '1');
+    CHECK(first.snapshot->getWorld().getShells().empty());
+
+    // A view that only moves '%' onto a cell that is not an own tank is a different board
+    ProbeTank fourth;
+    player.updateTankWithBattleInfo(fourth, *make_unique<GridView>(vector<string>{
+                                                "*  1 %",
+                                                " #  @ ",
+                                                "    1 "}));
+    CHECK(fourth.snapshot != third.snapshot);
+    CHECK(fourth.snapshot->getWorld().at(Position(5, 0)) == '1');
+
+    return Tests::finish("PlayerSnapshotTest");
+}
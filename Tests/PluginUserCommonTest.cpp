@@ -0,0 +1,35 @@
+#include "TestSupport.h"
+#include <filesystem>
+#include <string>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Every plugin runs the UserCommon it was built with: a game manager whose Position moves differently
+// plays differently from the in-tree one, instead of being bound to the simulator's copy
+int main()
+{
+    auto dir = Tests::workDir("plugin_user_common");
+    Tests::copyAlgorithms(dir / "algs", {"A", "B"});
+    // Wider than 64 columns, so the game managers move tanks through Position
+    CHECK(Tests::generateMaps(dir / "maps", "count=2 rows=20 cols=80 max_steps=300 seed=2"));
+    fs::create_directories(dir / "gms");
+    fs::copy_file("GameManager/GameManager.so", dir / "gms" / "Real.so");
+    CHECK(Tests::buildSkewedGameManager(dir / "gms" / "Skewed.so"));
+
+    CHECK(Tests::run("./Simulator/simulator -comparative game_map=" + (dir / "maps" / "m_0").string() +
+                     " game_managers_folder=" + (dir / "gms").string() + " algorithm1=" + (dir / "algs" / "A.so").string() +
+                     " algorithm2=" + (dir / "algs" / "B.so").string() + " > /dev/null 2>&1") == 0);
+
+    string results;
+    for (const auto &entry : fs::directory_iterator(dir / "gms"))
+    {
+        if (entry.path().extension() == ".txt")
+            results = Tests::readFile(entry.path());
+    }
+    // Grouped apart, each on a line of its own
+    CHECK(results.find("\nReal\n") != string::npos);
+    CHECK(results.find("\nSkewed\n") != string::npos);
+
+    return Tests::finish("PluginUserCommonTest");
+}
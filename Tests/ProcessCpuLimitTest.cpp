@@ -0,0 +1,37 @@
+#include "TestSupport.h"
+#include "Simulator/CompetitionTasks.h"
+#include <sys/resource.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// process_cpu_sec= limits each game, not the life of a worker: two workers play the games of 10 maps, which take well over
+// one budget per worker in total, and every game must still be scored
+int main()
+{
+    auto dir = Tests::workDir("process_cpu_limit");
+    Tests::copyAlgorithms(dir / "algs", {"A", "B", "C", "D"});
+    CHECK(Tests::generateMaps(dir / "maps", "count=10 rows=20 cols=25 max_steps=500 seed=5"));
+
+    struct rusage before, after;
+    getrusage(RUSAGE_CHILDREN, &before);
+    int status = Tests::run("./Simulator/simulator -competition game_maps_folder=" + (dir / "maps").string() +
+                            " game_manager=GameManager/GameManager.so algorithms_folder=" + (dir / "algs").string() +
+                            " num_processes=2 process_cpu_sec=1 results_log=" + (dir / "results.jsonl").string() +
+                            " > " + (dir / "stdout.txt").string() + " 2> " + (dir / "stderr.txt").string());
+    getrusage(RUSAGE_CHILDREN, &after);
+    CHECK(status == 0);
+
+    // Otherwise the run did not need more than one budget per worker and proves nothing
+    double cpuSec = (after.ru_utime.tv_sec - before.ru_utime.tv_sec) + (after.ru_utime.tv_usec - before.ru_utime.tv_usec) / 1e6;
+    CHECK(cpuSec > 2.0);
+
+    string errors = Tests::readFile(dir / "stderr.txt");
+    CHECK(errors.find("not scored") == string::npos);
+    CHECK(errors.find("games failed") == string::npos);
+    uint64_t games = CompetitionTasks(4, vector<uint64_t>(10, 1), CompetitionTasks::Pairing::Rotation).size();
+    CHECK(Tests::countLines(Tests::readFile(dir / "results.jsonl")) == games);
+
+    return Tests::finish("ProcessCpuLimitTest");
+}
@@ -0,0 +1,51 @@
+#include "TestSupport.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    // The fields of every logged game that do not depend on the run (not time, cache use or memory), sorted
+    vector<string> games(const string &log)
+    {
+        vector<string> lines;
+        istringstream in(log);
+        for (string line; getline(in, line);)
+            lines.push_back(line.substr(0, line.find(", \"time_ms\"")));
+        sort(lines.begin(), lines.end());
+        return lines;
+    }
+}
+
+// A competition resumed from journal= writes a results log that lists every game, the journaled ones as well
+int main()
+{
+    auto dir = Tests::workDir("resume_results_log");
+    Tests::copyAlgorithms(dir / "algs", {"A", "B", "C"});
+    CHECK(Tests::generateMaps(dir / "maps", "count=6 rows=10 cols=12 max_steps=150 seed=3"));
+    string competition = "./Simulator/simulator -competition game_maps_folder=" + (dir / "maps").string() +
+                         " game_manager=GameManager/GameManager.so algorithms_folder=" + (dir / "algs").string() +
+                         " journal=" + (dir / "journal.txt").string() + " results_log=" + (dir / "results.jsonl").string() +
+                         " > /dev/null 2>&1";
+
+    CHECK(Tests::run(competition) == 0);
+    vector<string> full = games(Tests::readFile(dir / "results.jsonl"));
+    CHECK(full.size() > 4);
+
+    // As if the run had died after four games: the journal keeps its header and the first four of them
+    istringstream journal(Tests::readFile(dir / "journal.txt"));
+    string kept, line;
+    for (int i = 0; i < 5 && getline(journal, line); ++i)
+        kept += line + "\n";
+    ofstream(dir / "journal.txt", ios::trunc) << kept;
+
+    CHECK(Tests::run(competition) == 0);
+    CHECK(games(Tests::readFile(dir / "results.jsonl")) == full);
+    CHECK(Tests::countLines(Tests::readFile(dir / "journal.txt")) == full.size() + 1);
+
+    return Tests::finish("ResumeResultsLogTest");
+}
@@ -0,0 +1,83 @@
+#include "TestSupport.h"
+#include <filesystem>
+#include <string>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Runs shard=<shard> of the competition and moves its result file to folder
+    bool runShard(const fs::path &dir, const string &maps, const string &shard, const fs::path &folder)
+    {
+        fs::create_directories(folder);
+        if (Tests::run("./Simulator/simulator -competition game_maps_folder=" + maps + " game_manager=GameManager/GameManager.so"
+                       " algorithms_folder=" + (dir / "algs").string() + " shard=" + shard + " > /dev/null 2>&1") != 0)
+            return false;
+        bool moved = false;
+        for (const auto &entry : fs::directory_iterator(dir / "algs"))
+        {
+            if (entry.path().extension() != ".txt")
+                continue;
+            fs::rename(entry.path(), folder / ("shard_" + shard.substr(0, shard.find('/')) + ".txt"));
+            moved = true;
+        }
+        return moved;
+    }
+
+    bool merge(const fs::path &folder)
+    {
+        return Tests::run("./Simulator/simulator -merge shards_folder=" + folder.string() + " > /dev/null 2>&1") == 0;
+    }
+
+    // The competition_*.txt result file in folder
+    fs::path resultFile(const fs::path &folder)
+    {
+        for (const auto &entry : fs::directory_iterator(folder))
+        {
+            if (entry.path().filename().string().rfind("competition_", 0) == 0)
+                return entry.path();
+        }
+        return {};
+    }
+}
+
+// Merge combines the shards of one competition into the result file of one unsharded run, and refuses
+// shards played on other map contents or with another result file header
+int main()
+{
+    auto dir = Tests::workDir("shard_merge");
+    Tests::copyAlgorithms(dir / "algs", {"A", "B", "C"});
+    CHECK(Tests::generateMaps(dir / "maps", "count=6 rows=10 cols=12 max_steps=150 seed=3"));
+    string maps = (dir / "maps").string();
+
+    CHECK(runShard(dir, maps, "0/2", dir / "same"));
+    CHECK(runShard(dir, maps, "1/2", dir / "same"));
+    CHECK(merge(dir / "same"));
+
+    fs::create_directories(dir / "unsharded");
+    CHECK(Tests::run("./Simulator/simulator -competition game_maps_folder=" + maps + " game_manager=GameManager/GameManager.so"
+                     " algorithms_folder=" + (dir / "algs").string() + " > /dev/null 2>&1") == 0);
+    fs::path unsharded = resultFile(dir / "algs");
+    CHECK(!unsharded.empty());
+    CHECK(!resultFile(dir / "same").empty());
+    CHECK(Tests::readFile(resultFile(dir / "same")) == Tests::readFile(unsharded));
+    fs::remove(unsharded);
+
+    // The same maps from another folder: the fingerprint agrees, the game_maps_folder line does not
+    fs::copy(dir / "maps", dir / "maps_copy");
+    fs::create_directories(dir / "other_folder");
+    fs::copy_file(dir / "same" / "shard_0.txt", dir / "other_folder" / "shard_0.txt");
+    CHECK(runShard(dir, (dir / "maps_copy").string(), "1/2", dir / "other_folder"));
+    CHECK(!merge(dir / "other_folder"));
+
+    // A map changed in place between the shards: same names and header, other contents
+    fs::create_directories(dir / "changed_map");
+    fs::copy_file(dir / "same" / "shard_0.txt", dir / "changed_map" / "shard_0.txt");
+    CHECK(Tests::generateMaps(dir / "regenerated", "count=6 rows=10 cols=12 max_steps=150 seed=4"));
+    fs::copy_file(dir / "regenerated" / "m_5", dir / "maps" / "m_5", fs::copy_options::overwrite_existing);
+    CHECK(runShard(dir, maps, "1/2", dir / "changed_map"));
+    CHECK(!merge(dir / "changed_map"));
+
+    return Tests::finish("ShardMergeTest");
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdlib>
+#include <sys/wait.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Minimal checks for the test programs: a failed CHECK is reported with its line, the program goes on,
+// and finish() makes it exit nonzero if anything failed
+namespace Tests
+{
+    inline int &failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    inline int finish(const char *name)
+    {
+        if (failures() == 0)
+            std::cout << name << ": OK\n";
+        else
+            std::cout << name << ": " << failures() << " check(s) failed\n";
+        return failures() == 0 ? 0 : 1;
+    }
+
+    // A fresh directory under Tests/work for one test; tests run from the repository root
+    inline std::filesystem::path workDir(const std::string &name)
+    {
+        std::filesystem::path dir = std::filesystem::path("Tests") / "work" / name;
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        return dir;
+    }
+
+    // Exit status of a shell command, -1 if it did not exit normally
+    inline int run(const std::string &command)
+    {
+        int status = std::system(command.c_str());
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    inline std::string readFile(const std::filesystem::path &path)
+    {
+        std::ifstream in(path);
+        std::ostringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+
+    inline size_t countLines(const std::string &text)
+    {
+        size_t lines = 0;
+        for (char c : text)
+            lines += c == '\n';
+        return lines;
+    }
+
+    // count maps from the map generator in folder, named m_0, m_1, ...
+    inline bool generateMaps(const std::filesystem::path &folder, const std::string &args)
+    {
+        std::filesystem::create_directories(folder);
+        return run("./MapGenerator/map_generator output=" + (folder / "m").string() + " " + args + " > /dev/null") == 0;
+    }
+
+    // Algorithms folder with copies of the in-tree algorithm under the given names
+    inline void copyAlgorithms(const std::filesystem::path &folder, std::initializer_list<const char *> names)
+    {
+        std::filesystem::create_directories(folder);
+        for (const char *name : names)
+            std::filesystem::copy_file("Algorithm/Algorithm.so", folder / (std::string(name) + ".so"),
+                                       std::filesystem::copy_options::overwrite_existing);
+    }
+
+    // A GameManager.so from the in-tree sources, except that its own UserCommon moves twice as far along x
+    // in Position::operator+. Anything that runs it with another build's UserCommon plays it like the real one.
+    inline bool buildSkewedGameManager(const std::filesystem::path &so)
+    {
+        namespace fs = std::filesystem;
+        fs::path position = so.parent_path() / "SkewedPosition.cpp";
+        std::string source = readFile("UserCommon/Position.cpp");
+        size_t at = source.find("(x + other.x)");
+        if (at == std::string::npos)
+            return false;
+        source.replace(at, 13, "(x + 2 * other.x)");
+        std::ofstream(position) << source;
+
+        std::string sources = position.string();
+        for (const char *folder : {"GameManager", "UserCommon"})
+        {
+            for (const auto &entry : fs::directory_iterator(folder))
+            {
+                if (entry.path().extension() == ".cpp" && entry.path().filename() != "Position.cpp")
+                    sources += " " + entry.path().string();
+            }
+        }
+        return run("g++ -fPIC -shared -std=c++20 -I. -IUserCommon -o " + so.string() + " " + sources) == 0;
+    }
+}
+
+#define CHECK(condition)                                                                     \
+    do                                                                                       \
+    {                                                                                        \
+        if (!(condition))                                                                    \
+        {                                                                                    \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            ++Tests::failures();                                                             \
+        }                                                                                    \
+    } while (0)
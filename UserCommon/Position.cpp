@@ -11,8 +11,8 @@ namespace UserCommon
 {
     using namespace std;
 
-    int Position::width = 0;
-    int Position::height = 0;
+    thread_local int Position::width = 0;
+    thread_local int Position::height = 0;
     Position::Position() : x(-1), y(-1) {};
     Position::Position(int x, int y) : x(x), y(y) {};
 
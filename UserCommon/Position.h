@@ -14,7 +14,8 @@ namespace UserCommon
     class Position
     {
     public:
-        static int width, height;
+        // Wrap-around dimensions of the board being played; per thread, since each thread runs its own game
+        static thread_local int width, height;
         int x, y;
         Position();
         Position(int x, int y);